@@ -3,6 +3,35 @@ solution("nether")
 
 dofile("3rdparty/genius/genius.lua")
 
+newoption {
+	trigger = "gl-backend",
+	value = "BACKEND",
+	description = "Dispatch backend used by the nether::gl functions",
+	allowed = {
+		{ "virtual", "Runtime selected through the OpenGLFunctions interface (default, required for Qt)" },
+		{ "glad_direct", "Calls resolved statically to the GLAD entry points" }
+	}
+}
+
+newoption {
+	trigger = "gl-error-check",
+	value = "LEVEL",
+	description = "Maximum GL error checking tier (default: call in debug, frame in release, off in profile)",
+	allowed = {
+		{ "off", "No glGetError calls" },
+		{ "frame", "One error drain per frame" },
+		{ "scope", "Per frame plus NETHER_GL_ERROR_SCOPE blocks" },
+		{ "call", "glGetError after every nether::gl call" }
+	}
+}
+
+newoption {
+	trigger = "lto",
+	description = "Enable link time optimization in the release and profile configurations"
+}
+
+local glErrorCheckLevels = { off = 0, frame = 1, scope = 2, call = 3 }
+
 group "3rdparty"
 defineSDLLib(true, "3rdparty/sdl", "build")
 
@@ -25,15 +54,27 @@ function netherProject(projectName)
 	project (projectName)
 	kind "ConsoleApp"
 	language "C++"
-	configurations { "debug", "release" }
+	configurations { "debug", "release", "profile" }
 	platforms { "x32", "x64" }
-	defines { "GLAD_GL_IMPLEMENTATION" }
+	defines { "AETHER_USE_GLAD" }
 	flags{ "CppLatest" }
+
+	if _OPTIONS["gl-backend"] == "glad_direct" then
+		defines { "NETHER_GL_BACKEND_GLAD_DIRECT" }
+	end
 	objdir("build")
 	targetdir("build")
 	debugdir(".")
 
 	configuration {}
+		links {
+			"sdl-image",
+			"libpng",
+			"zlib",
+			"sdl"
+		}
+
+	configuration { "windows" }
 		links {
 			"DelayImp",
 			"gdi32",
@@ -42,12 +83,18 @@ function netherProject(projectName)
 			"imm32",
 			"version",
 			"Setupapi",
-			"opengl32",
-			"libpng",
-			"zlib",
-			"sdl-image",
-			"sdl"
+			"opengl32"
 		}
+
+	configuration { "linux" }
+		links {
+			"GL",
+			"EGL",
+			"dl",
+			"pthread"
+		}
+
+	configuration {}
 		includedirs {
 			"src",
 			"3rdparty/glad/include",
@@ -73,6 +120,9 @@ function netherProject(projectName)
 	configuration { "vs20*", "release" }
 		links { "LIBCMT" }
 
+	configuration { "vs20*", "profile" }
+		links { "LIBCMT" }
+
 	configuration {}
 		flags {
 			"StaticRuntime"
@@ -89,7 +139,44 @@ function netherProject(projectName)
 			"OptimizeSize",
 			"OptimizeSpeed"
 		}
+		defines { "NDEBUG" }
+
+	-- Release optimizations plus what a sampling profiler needs to walk stacks
+	configuration { "profile" }
+		flags {
+			"Symbols",
+			"Optimize",
+			"OptimizeSpeed"
+		}
+		defines { "NDEBUG" }
+
+	configuration { "profile", "not vs20*" }
+		buildoptions { "-fno-omit-frame-pointer" }
 
+	configuration { "profile", "vs20*" }
+		buildoptions { "/Oy-" }
+
+	if _OPTIONS["lto"] then
+		configuration { "release" }
+			flags { "LinkTimeOptimization" }
+
+		configuration { "profile" }
+			flags { "LinkTimeOptimization" }
+	end
+
+	if _OPTIONS["gl-error-check"] then
+		configuration {}
+			defines { "NETHER_GL_ERROR_CHECK_LEVEL=" .. glErrorCheckLevels[_OPTIONS["gl-error-check"]] }
+	else
+		configuration { "debug" }
+			defines { "NETHER_GL_ERROR_CHECK_LEVEL=3" }
+
+		configuration { "release" }
+			defines { "NETHER_GL_ERROR_CHECK_LEVEL=1" }
+
+		configuration { "profile" }
+			defines { "NETHER_GL_ERROR_CHECK_LEVEL=0" }
+	end
 
 	configuration {}
 end
@@ -106,6 +193,37 @@ function netherTest(num, folderName)
 			}
 end
 
+-- Benchmarks land in build/bench so they can be run as a set; build them
+-- with the profile configuration to get optimized code with usable stacks
+function netherBench(folderName)
+	netherProject("nether-bench-" .. folderName)
+		targetdir("build/bench")
+
+		configuration{}
+			files {
+				"src/bench/" .. folderName .. "/*.h",
+				"src/bench/" .. folderName .. "/*.cpp",
+			}
+			includedirs {
+				"src/bench/" .. folderName .. "/",
+			}
+end
+
+-- Command line tools land in build/tools
+function netherTool(folderName)
+	netherProject("nether-" .. folderName)
+		targetdir("build/tools")
+
+		configuration{}
+			files {
+				"src/tools/" .. folderName .. "/*.h",
+				"src/tools/" .. folderName .. "/*.cpp",
+			}
+			includedirs {
+				"src/tools/" .. folderName .. "/",
+			}
+end
+
 group("tests")
 
 netherTest(1, "hello-triangle")
@@ -114,3 +232,15 @@ netherTest(3, "textures")
 netherTest(4, "coordinate-systems")
 netherTest(5, "transformations")
 netherTest(6, "camera")
+
+group("bench")
+
+netherBench("gl-dispatch")
+netherBench("draw-sort")
+netherBench("gpu-cull")
+netherBench("frustum-cull")
+netherBench("texture-load")
+
+group("tools")
+
+netherTool("texcook")
@@ -0,0 +1,509 @@
+// Compares state changes and frame cost of submitting the camera sample's cubes
+// in recording order, sorted by SortKey, sorted with automatic instancing, and
+// sorted with the meshes in one GeometryPool drawn through multi draw indirect.
+//
+// The scene is the camera sample scaled up: a grid of textured cubes, each given
+// one of a few programs, texture pairs and VAOs at random, so recording order is
+// the worst case for state changes. Runs on the headless context.
+//
+//  nether-bench-draw-sort [cubes per side, default 16; 47 gives ~100k cubes]
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <nether/GeometryPool.h>
+#include <nether/HeadlessContext.h>
+#include <nether/Renderer.h>
+#include <nether/ShaderProgram.h>
+#include <nether/StreamingBuffer.h>
+#include <nether/Texture.h>
+#include <nether/UniformBuffer.h>
+#include <nether/VertexArrayObject.h>
+#include <nether/BufferObject.h>
+
+namespace
+{
+    constexpr int kWidth = 800;
+    constexpr int kHeight = 600;
+    constexpr int kPrograms = 4;
+    constexpr int kTexturePairs = 8;
+    constexpr int kVaos = 2;
+    constexpr int kFrames = 60;
+    constexpr float kFar = 200.f;
+
+    const char* kVertexShader = R"(
+        #version 330 core
+        layout (location = 0) in vec3 aPos;
+        layout (location = 1) in vec2 aTexCoord;
+        out vec2 TexCoord;
+        layout (std140) uniform Camera
+        {
+            mat4 view;
+            mat4 projection;
+            mat4 viewProjection;
+            vec4 position;
+        };
+        layout (std140) uniform Object
+        {
+            mat4 model;
+        };
+        void main()
+        {
+            gl_Position = viewProjection * model * vec4(aPos, 1.0);
+            TexCoord = aTexCoord;
+        }
+    )";
+
+    // Same as above with the model matrix as a per instance attribute
+    const char* kInstancedVertexShader = R"(
+        #version 330 core
+        layout (location = 0) in vec3 aPos;
+        layout (location = 1) in vec2 aTexCoord;
+        layout (location = 4) in mat4 instanceModel;
+        out vec2 TexCoord;
+        layout (std140) uniform Camera
+        {
+            mat4 view;
+            mat4 projection;
+            mat4 viewProjection;
+            vec4 position;
+        };
+        void main()
+        {
+            gl_Position = viewProjection * instanceModel * vec4(aPos, 1.0);
+            TexCoord = aTexCoord;
+        }
+    )";
+
+    // Model matrices read from the renderer's draw data buffer by draw index
+    const char* kIndirectVertexShader = R"(
+        #version 430 core
+        #extension GL_ARB_shader_draw_parameters : require
+        layout (location = 0) in vec3 aPos;
+        layout (location = 1) in vec2 aTexCoord;
+        out vec2 TexCoord;
+        layout (std140) uniform Camera
+        {
+            mat4 view;
+            mat4 projection;
+            mat4 viewProjection;
+            vec4 position;
+        };
+        layout (std430, binding = 2) readonly buffer DrawData
+        {
+            mat4 drawModel[];
+        };
+        void main()
+        {
+            gl_Position = viewProjection * drawModel[gl_DrawIDARB] * vec4(aPos, 1.0);
+            TexCoord = aTexCoord;
+        }
+    )";
+
+    // Each program only differs by its tint, which is enough to make them distinct
+    const char* kFragmentShader = R"(
+        #version 330 core
+        out vec4 FragColor;
+        in vec2 TexCoord;
+        uniform sampler2D texture1;
+        uniform sampler2D texture2;
+        void main()
+        {
+            FragColor = mix(texture(texture1, TexCoord), texture(texture2, TexCoord), 0.2) * vec4(TINT, 1.0);
+        }
+    )";
+
+    const float kCube[] = {
+        -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,   0.5f, -0.5f, -0.5f,  1.0f, 0.0f,   0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+         0.5f,  0.5f, -0.5f,  1.0f, 1.0f,  -0.5f,  0.5f, -0.5f,  0.0f, 1.0f,  -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
+        -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,   0.5f, -0.5f,  0.5f,  1.0f, 0.0f,   0.5f,  0.5f,  0.5f,  1.0f, 1.0f,
+         0.5f,  0.5f,  0.5f,  1.0f, 1.0f,  -0.5f,  0.5f,  0.5f,  0.0f, 1.0f,  -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+        -0.5f,  0.5f,  0.5f,  1.0f, 0.0f,  -0.5f,  0.5f, -0.5f,  1.0f, 1.0f,  -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+        -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,  -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,  -0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+         0.5f,  0.5f,  0.5f,  1.0f, 0.0f,   0.5f,  0.5f, -0.5f,  1.0f, 1.0f,   0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+         0.5f, -0.5f, -0.5f,  0.0f, 1.0f,   0.5f, -0.5f,  0.5f,  0.0f, 0.0f,   0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+        -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,   0.5f, -0.5f, -0.5f,  1.0f, 1.0f,   0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+         0.5f, -0.5f,  0.5f,  1.0f, 0.0f,  -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,  -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+        -0.5f,  0.5f, -0.5f,  0.0f, 1.0f,   0.5f,  0.5f, -0.5f,  1.0f, 1.0f,   0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+         0.5f,  0.5f,  0.5f,  1.0f, 0.0f,  -0.5f,  0.5f,  0.5f,  0.0f, 0.0f,  -0.5f,  0.5f, -0.5f,  0.0f, 1.0f
+    };
+
+    struct Cube
+    {
+        glm::mat4 model;
+        float depth = 0.f;
+        int program = 0;
+        int texturePair = 0;
+        int vao = 0;
+    };
+
+    enum class Mode
+    {
+        Unsorted,
+        Sorted,
+        Instanced,
+        Indirect
+    };
+
+    struct Scene
+    {
+        nether::ShaderProgram programs[kPrograms];
+        nether::ShaderProgram instancedPrograms[kPrograms];
+        nether::ShaderProgram indirectPrograms[kPrograms];
+        nether::Texture textures[kTexturePairs * 2];
+        nether::VertexArrayObject vaos[kVaos];
+        nether::BufferObject vbos[kVaos];
+        // The same meshes as the VAOs, packed into one pool
+        nether::GeometryPool pool;
+        nether::PooledMesh meshes[kVaos];
+        nether::UniformBuffer<nether::CameraBlock> camera;
+        nether::StreamingBuffer objects;
+        std::vector<Cube> cubes;
+    };
+
+    double NowMs()
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void CreateScene(Scene& scene, int cubesPerSide)
+    {
+        const float tints[kPrograms][3] = { { 1, 1, 1 }, { 1, .8f, .8f }, { .8f, 1, .8f }, { .8f, .8f, 1 } };
+        for (int i = 0; i < kPrograms; i++)
+        {
+            char tint[64];
+            snprintf(tint, sizeof(tint), "vec3(%.2f, %.2f, %.2f)", tints[i][0], tints[i][1], tints[i][2]);
+            std::string fragment = kFragmentShader;
+            fragment.replace(fragment.find("TINT"), 4, tint);
+
+            nether::ShaderProgram& program = scene.programs[i];
+            program.LoadFromRawStrings(kVertexShader, fragment);
+            program.Use();
+            program.SetIntUniform("texture1", 0);
+            program.SetIntUniform("texture2", 1);
+            program.BindUniformBlock(nether::CameraBlock::Name, nether::CameraBlock::Binding);
+            program.BindUniformBlock(nether::ObjectBlock::Name, nether::ObjectBlock::Binding);
+
+            nether::ShaderProgram& instancedProgram = scene.instancedPrograms[i];
+            instancedProgram.LoadFromRawStrings(kInstancedVertexShader, fragment);
+            instancedProgram.Use();
+            instancedProgram.SetIntUniform("texture1", 0);
+            instancedProgram.SetIntUniform("texture2", 1);
+            instancedProgram.BindUniformBlock(nether::CameraBlock::Name, nether::CameraBlock::Binding);
+
+            nether::ShaderProgram& indirectProgram = scene.indirectPrograms[i];
+            indirectProgram.LoadFromRawStrings(kIndirectVertexShader, fragment);
+            indirectProgram.Use();
+            indirectProgram.SetIntUniform("texture1", 0);
+            indirectProgram.SetIntUniform("texture2", 1);
+            indirectProgram.BindUniformBlock(nether::CameraBlock::Name, nether::CameraBlock::Binding);
+        }
+
+        for (int i = 0; i < kTexturePairs * 2; i++)
+        {
+            unsigned char pixels[4 * 4 * 4];
+            for (int p = 0; p < 16; p++)
+            {
+                pixels[p * 4 + 0] = (unsigned char)(40 * i);
+                pixels[p * 4 + 1] = (unsigned char)(255 - 16 * i);
+                pixels[p * 4 + 2] = (unsigned char)(p * 16);
+                pixels[p * 4 + 3] = 255;
+            }
+            scene.textures[i].Create(4, 4, pixels, nether::TextureFormat::RGBA8, false);
+        }
+
+        std::vector<float> vertices(std::begin(kCube), std::end(kCube));
+        for (int i = 0; i < kVaos; i++)
+        {
+            scene.vaos[i].Generate();
+            scene.vbos[i].Generate(nether::BufferBindingTarget::ArrayBuffer);
+            scene.vaos[i].Bind();
+            scene.vbos[i].Bind();
+            scene.vbos[i].UploadBufferData(vertices);
+            scene.vaos[i].AddVertexAttribPointer(0, 3, nether::GLType::Float, nether::GLBoolean::False, 5 * sizeof(float), (void*)0);
+            scene.vaos[i].EnableVertexAttribArray(0);
+            scene.vaos[i].AddVertexAttribPointer(1, 2, nether::GLType::Float, nether::GLBoolean::False, 5 * sizeof(float), (void*)(3 * sizeof(float)));
+            scene.vaos[i].EnableVertexAttribArray(1);
+            scene.vaos[i].Unbind();
+        }
+
+        std::vector<unsigned int> indices(36);
+        for (unsigned int i = 0; i < 36; i++)
+        {
+            indices[i] = i;
+        }
+        scene.pool.Generate(5 * sizeof(float));
+        scene.pool.AddVertexAttribute(0, 3, nether::GLType::Float, 0);
+        scene.pool.AddVertexAttribute(1, 2, nether::GLType::Float, 3 * sizeof(float));
+        for (int i = 0; i < kVaos; i++)
+        {
+            scene.meshes[i] = scene.pool.AddMesh(vertices, indices);
+        }
+
+        const glm::vec3 eye(0.f, 0.f, 3.f);
+        nether::CameraBlock block;
+        block.view = glm::lookAt(eye, glm::vec3(0.f, 0.f, -1.f), glm::vec3(0.f, 1.f, 0.f));
+        block.projection = glm::perspective(glm::radians(45.f), float(kWidth) / float(kHeight), 0.1f, kFar);
+        block.viewProjection = block.projection * block.view;
+        block.position = glm::vec4(eye, 1.f);
+        scene.camera.Generate(nether::CameraBlock::Binding);
+        scene.camera.Upload(block);
+
+        std::mt19937 random(1234);
+        for (int x = 0; x < cubesPerSide; x++)
+        {
+            for (int y = 0; y < cubesPerSide; y++)
+            {
+                for (int z = 0; z < cubesPerSide; z++)
+                {
+                    glm::vec3 position(2.f * (x - cubesPerSide / 2), 2.f * (y - cubesPerSide / 2), -2.f * z - 5.f);
+
+                    Cube cube;
+                    cube.model = glm::translate(glm::mat4(1.f), position);
+                    cube.depth = glm::length(position - eye) / kFar;
+                    cube.program = int(random() % kPrograms);
+                    cube.texturePair = int(random() % kTexturePairs);
+                    cube.vao = int(random() % kVaos);
+                    scene.cubes.push_back(cube);
+                }
+            }
+        }
+
+        // One region holds every cube's block at the UBO offset alignment
+        scene.objects.Generate(nether::BufferBindingTarget::UniformBuffer, (long long)scene.cubes.size() * 256);
+    }
+
+    void Record(Scene& scene, nether::CommandBuffer& commands, Mode mode)
+    {
+        commands.Clear();
+        for (const Cube& cube : scene.cubes)
+        {
+            if (mode == Mode::Indirect)
+            {
+                const nether::PooledMesh& mesh = scene.meshes[cube.vao];
+                nether::DrawPacket& packet = commands.DrawElements(scene.indirectPrograms[cube.program].GetProgram(), scene.pool.GetVAO(), GL_TRIANGLES,
+                        mesh.indexCount, GL_UNSIGNED_INT, mesh.GetIndexByteOffset(), mesh.baseVertex)
+                    .SetTexture(0, scene.textures[cube.texturePair * 2].GetTextureID())
+                    .SetTexture(1, scene.textures[cube.texturePair * 2 + 1].GetTextureID())
+                    .SetTransform(cube.model)
+                    .GetPacket();
+                packet.sortKey = nether::SortKey::ForPacket(packet, 0, false, cube.depth);
+                continue;
+            }
+
+            if (mode == Mode::Instanced)
+            {
+                nether::DrawPacket& packet = commands.DrawArrays(scene.instancedPrograms[cube.program].GetProgram(), scene.vaos[cube.vao].GetVAO(), GL_TRIANGLES, 0, 36)
+                    .SetTexture(0, scene.textures[cube.texturePair * 2].GetTextureID())
+                    .SetTexture(1, scene.textures[cube.texturePair * 2 + 1].GetTextureID())
+                    .SetTransform(cube.model)
+                    .GetPacket();
+                packet.sortKey = nether::SortKey::ForPacket(packet, 0, false, cube.depth);
+                continue;
+            }
+
+            nether::StreamingAllocation object = scene.objects.Allocate(sizeof(nether::ObjectBlock));
+            memcpy(object.data, &cube.model, sizeof(cube.model));
+
+            nether::DrawPacket& packet = commands.DrawArrays(scene.programs[cube.program].GetProgram(), scene.vaos[cube.vao].GetVAO(), GL_TRIANGLES, 0, 36)
+                .SetTexture(0, scene.textures[cube.texturePair * 2].GetTextureID())
+                .SetTexture(1, scene.textures[cube.texturePair * 2 + 1].GetTextureID())
+                .SetUniformRange(nether::ObjectBlock::Binding, scene.objects, object)
+                .GetPacket();
+            packet.sortKey = nether::SortKey::ForPacket(packet, 0, false, cube.depth);
+        }
+    }
+
+    void RunFrames(Scene& scene, nether::Renderer& renderer, nether::CommandBuffer& commands, Mode mode, const char* name)
+    {
+        renderer.ResetStats();
+        double cpuMs = 0.0;
+        double frameMs = 0.0;
+
+        for (int frame = 0; frame < kFrames; frame++)
+        {
+            double start = NowMs();
+            scene.objects.BeginFrame();
+            renderer.BeginFrame();
+            renderer.BeginRender();
+
+            Record(scene, commands, mode);
+            if (mode == Mode::Unsorted)
+            {
+                renderer.Submit(commands);
+            }
+            else if (mode == Mode::Indirect)
+            {
+                renderer.SubmitIndirect(commands);
+            }
+            else
+            {
+                renderer.SubmitSorted(commands);
+            }
+
+            renderer.EndFrame();
+            scene.objects.EndFrame();
+            cpuMs += NowMs() - start;
+
+            nether::gl::finish();
+            frameMs += NowMs() - start;
+        }
+
+        const nether::RenderStats& stats = renderer.GetStats();
+        printf("%-10s %8llu draws %8llu programs %8llu vaos %8llu textures %8.3f ms cpu %8.3f ms frame\n", name,
+            stats.drawCalls / kFrames, stats.programChanges / kFrames, stats.vaoChanges / kFrames,
+            stats.textureChanges / kFrames, cpuMs / kFrames, frameMs / kFrames);
+    }
+
+    // A packet with both a transform and its own instancing must be drawn as recorded,
+    // not merged into an automatic instanced or multi draw batch
+    bool CheckOwnInstancing(Scene& scene, nether::Renderer& renderer, nether::CommandBuffer& commands)
+    {
+        constexpr int kInstances = 3;
+        constexpr unsigned int kCubeTriangles = 12;
+
+        unsigned int query = 0;
+        nether::gl::genQueries(1, &query);
+        bool passed = true;
+        for (Mode mode : { Mode::Sorted, Mode::Indirect })
+        {
+            commands.Clear();
+            scene.objects.BeginFrame();
+            renderer.BeginFrame();
+            for (int i = 0; i < 2; i++)
+            {
+                nether::StreamingAllocation object = scene.objects.Allocate(sizeof(nether::ObjectBlock));
+                memcpy(object.data, &scene.cubes[i].model, sizeof(glm::mat4));
+                nether::CommandBuffer::PacketBuilder builder = mode == Mode::Indirect
+                    ? commands.DrawElements(scene.programs[0].GetProgram(), scene.pool.GetVAO(), GL_TRIANGLES,
+                        scene.meshes[0].indexCount, GL_UNSIGNED_INT, scene.meshes[0].GetIndexByteOffset(), scene.meshes[0].baseVertex)
+                    : commands.DrawArrays(scene.programs[0].GetProgram(), scene.vaos[0].GetVAO(), GL_TRIANGLES, 0, 36);
+                builder.SetTexture(0, scene.textures[0].GetTextureID())
+                    .SetTexture(1, scene.textures[1].GetTextureID())
+                    .SetUniformRange(nether::ObjectBlock::Binding, scene.objects, object)
+                    .SetTransform(scene.cubes[i].model)
+                    .SetInstances(kInstances);
+            }
+
+            nether::gl::beginQuery(GL_PRIMITIVES_GENERATED, query);
+            if (mode == Mode::Indirect)
+            {
+                renderer.SubmitIndirect(commands);
+            }
+            else
+            {
+                renderer.SubmitSorted(commands);
+            }
+            nether::gl::endQuery(GL_PRIMITIVES_GENERATED);
+            renderer.EndFrame();
+            scene.objects.EndFrame();
+
+            unsigned int primitives = 0;
+            nether::gl::getQueryObjectuiv(query, GL_QUERY_RESULT, &primitives);
+            if (primitives != 2 * kInstances * kCubeTriangles)
+            {
+                printf("%s: packets with their own instancing drew %u triangles, expected %u\n",
+                    mode == Mode::Indirect ? "indirect" : "sorted", primitives, 2 * kInstances * kCubeTriangles);
+                passed = false;
+            }
+        }
+        nether::gl::deleteQueries(1, &query);
+        commands.Clear();
+        return passed;
+    }
+
+    void BenchmarkSort(size_t count)
+    {
+        std::mt19937_64 random(42);
+        std::vector<nether::SortItem> keys(count);
+        for (size_t i = 0; i < count; i++)
+        {
+            keys[i].key = random();
+            keys[i].index = (unsigned int)i;
+        }
+
+        std::vector<nether::SortItem> items = keys;
+        std::vector<nether::SortItem> scratch;
+        double start = NowMs();
+        nether::RadixSort(items, scratch);
+        double radixMs = NowMs() - start;
+
+        items = keys;
+        start = NowMs();
+        std::stable_sort(items.begin(), items.end(), [](const nether::SortItem& a, const nether::SortItem& b) { return a.key < b.key; });
+        double stdMs = NowMs() - start;
+
+        printf("sort %8zu keys: radix %8.3f ms, std::stable_sort %8.3f ms\n", count, radixMs, stdMs);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    int cubesPerSide = argc > 1 ? atoi(argv[1]) : 16;
+    if (cubesPerSide <= 0)
+    {
+        return EXIT_FAILURE;
+    }
+
+    nether::HeadlessContext ctx;
+    if (!ctx.Init(kWidth, kHeight))
+    {
+        return EXIT_FAILURE;
+    }
+
+    bool passed = true;
+    {
+        Scene scene;
+        CreateScene(scene, cubesPerSide);
+
+        nether::Renderer renderer;
+        renderer.SetColorBufferBit(true);
+        renderer.SetDepthBufferBit(true);
+
+        nether::CommandBuffer commands;
+        commands.Reserve(scene.cubes.size());
+
+        printf("%zu cubes, %d programs, %d texture pairs, %d vaos, averaged over %d frames\n",
+            scene.cubes.size(), kPrograms, kTexturePairs, kVaos, kFrames);
+        renderer.InitInstancing(int(scene.cubes.size()));
+        renderer.InitIndirect(int(scene.cubes.size()));
+
+        RunFrames(scene, renderer, commands, Mode::Unsorted, "unsorted");
+        RunFrames(scene, renderer, commands, Mode::Sorted, "sorted");
+        RunFrames(scene, renderer, commands, Mode::Instanced, "instanced");
+        RunFrames(scene, renderer, commands, Mode::Indirect, "indirect");
+        passed = CheckOwnInstancing(scene, renderer, commands);
+
+        BenchmarkSort(scene.cubes.size());
+        BenchmarkSort(1000000);
+
+        renderer.ShutdownInstancing();
+        renderer.ShutdownIndirect();
+        scene.pool.Delete();
+        scene.objects.Delete();
+        scene.camera.Delete();
+        for (int i = 0; i < kVaos; i++)
+        {
+            scene.vaos[i].Delete();
+            scene.vbos[i].Delete();
+        }
+        for (int i = 0; i < kPrograms; i++)
+        {
+            scene.programs[i].Delete();
+            scene.instancedPrograms[i].Delete();
+            scene.indirectPrograms[i].Delete();
+        }
+    }
+
+    ctx.Cleanup();
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
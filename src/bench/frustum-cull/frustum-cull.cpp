@@ -0,0 +1,125 @@
+// Throughput of CPU frustum culling over bounding spheres and boxes with each
+// instruction set the CPU supports, checking they all find the same objects.
+//
+// Objects are scattered around a camera looking down -z; how many are visible
+// does not change the cost much since the loops do not branch per object.
+// Does not need a GL context.
+//
+//  nether-bench-frustum-cull [objects, default 1000000]
+#include <stdlib.h>
+#include <stdio.h>
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <nether/FrustumCulling.h>
+
+namespace
+{
+    constexpr int kIterations = 50;
+    constexpr float kExtent = 500.f;
+
+    double NowMs()
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    template <typename Cull>
+    size_t Run(const char* shape, nether::CullSimd simd, size_t objects, std::vector<unsigned int>& visible, Cull cull)
+    {
+        size_t count = cull(visible.data(), simd);
+        double best = 1e30;
+        double total = 0.0;
+        for (int iteration = 0; iteration < kIterations; iteration++)
+        {
+            const double start = NowMs();
+            count = cull(visible.data(), simd);
+            const double ms = NowMs() - start;
+            best = ms < best ? ms : best;
+            total += ms;
+        }
+
+        printf("%-7s %-7s %8zu visible %8.3f ms avg %8.3f ms best %8.1f Mobjects/s\n", shape, nether::GetCullSimdName(simd),
+            count, total / kIterations, best, objects / best * 1e-3);
+        return count;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const long long objects = argc > 1 ? atoll(argv[1]) : 1000000;
+    if (objects <= 0)
+    {
+        return EXIT_FAILURE;
+    }
+
+    std::mt19937 random(1234);
+    std::uniform_real_distribution<float> position(-kExtent, kExtent);
+    std::uniform_real_distribution<float> size(0.5f, 4.f);
+
+    nether::BoundingSpheres spheres;
+    nether::BoundingBoxes boxes;
+    spheres.Reserve(objects);
+    boxes.Reserve(objects);
+    for (long long i = 0; i < objects; i++)
+    {
+        const glm::vec3 center(position(random), position(random), position(random));
+        const float radius = size(random);
+        spheres.Add(center, radius);
+        boxes.Add(center - glm::vec3(radius), center + glm::vec3(radius));
+    }
+
+    const glm::mat4 view = glm::lookAt(glm::vec3(0.f), glm::vec3(0.f, 0.f, -1.f), glm::vec3(0.f, 1.f, 0.f));
+    const glm::mat4 projection = glm::perspective(glm::radians(60.f), 16.f / 9.f, 0.1f, kExtent);
+    const nether::Frustum frustum = nether::Frustum::FromMatrix(projection * view);
+
+    printf("%lld objects, best of %d runs, cpu supports %s\n", objects, kIterations,
+        nether::GetCullSimdName(nether::GetSupportedCullSimd()));
+
+    std::vector<unsigned int> visible(objects);
+    std::vector<unsigned int> reference;
+    int result = EXIT_SUCCESS;
+
+    const nether::CullSimd levels[] = { nether::CullSimd::Scalar, nether::CullSimd::Sse, nether::CullSimd::Avx2 };
+    for (int shape = 0; shape < 2; shape++)
+    {
+        for (nether::CullSimd simd : levels)
+        {
+            if (int(simd) > int(nether::GetSupportedCullSimd()))
+            {
+                continue;
+            }
+
+            size_t count = 0;
+            if (shape == 0)
+            {
+                count = Run("spheres", simd, objects, visible, [&](unsigned int* out, nether::CullSimd level) {
+                    return nether::CullSpheres(frustum, spheres, out, level);
+                });
+            }
+            else
+            {
+                count = Run("boxes", simd, objects, visible, [&](unsigned int* out, nether::CullSimd level) {
+                    return nether::CullBoxes(frustum, boxes, out, level);
+                });
+            }
+
+            if (simd == nether::CullSimd::Scalar)
+            {
+                reference.assign(visible.begin(), visible.begin() + count);
+            }
+            else if (count != reference.size() || !std::equal(reference.begin(), reference.end(), visible.begin()))
+            {
+                printf("%s does not match the scalar results\n", nether::GetCullSimdName(simd));
+                result = EXIT_FAILURE;
+            }
+        }
+    }
+
+    return result;
+}
@@ -0,0 +1,246 @@
+// Frustum culls a field of cubes on the CPU and with GpuCuller, then draws the GPU
+// culled set with one multi draw indirect call.
+//
+// Cubes are scattered in a volume around a camera that turns a little every frame,
+// so roughly a sixth of them is visible at any time. The CPU pass is the plain loop
+// over Frustum::IntersectsSphere that would otherwise feed the draws; the GPU pass
+// is timed with GpuProfiler. Both visible counts are compared on the first frame.
+// Runs on the headless context.
+//
+//  nether-bench-gpu-cull [cubes, default 262144]
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <nether/Frustum.h>
+#include <nether/GeometryPool.h>
+#include <nether/GpuCuller.h>
+#include <nether/GpuProfiler.h>
+#include <nether/HeadlessContext.h>
+#include <nether/ShaderProgram.h>
+#include <nether/UniformBuffer.h>
+
+namespace
+{
+    constexpr int kWidth = 800;
+    constexpr int kHeight = 600;
+    constexpr int kFrames = 60;
+    constexpr int kMeshes = 2;
+    constexpr float kExtent = 200.f;
+
+    const char* kVertexShader = R"(
+        #version 430 core
+        #extension GL_ARB_shader_draw_parameters : require
+        layout (location = 0) in vec3 aPos;
+        layout (std140) uniform Camera
+        {
+            mat4 view;
+            mat4 projection;
+            mat4 viewProjection;
+            vec4 position;
+        };
+        layout (std430, binding = 4) readonly buffer Visible
+        {
+            mat4 visibleModel[];
+        };
+        out vec3 Color;
+        void main()
+        {
+            gl_Position = viewProjection * visibleModel[gl_BaseInstanceARB + gl_InstanceID] * vec4(aPos, 1.0);
+            Color = aPos + 0.5;
+        }
+    )";
+
+    const char* kFragmentShader = R"(
+        #version 430 core
+        in vec3 Color;
+        out vec4 FragColor;
+        void main()
+        {
+            FragColor = vec4(Color, 1.0);
+        }
+    )";
+
+    double NowMs()
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    nether::CameraBlock MakeCamera(int frame)
+    {
+        const glm::vec3 eye(0.f);
+        const float yaw = glm::radians(frame * 3.f);
+        const glm::vec3 front(glm::sin(yaw), 0.f, -glm::cos(yaw));
+
+        nether::CameraBlock block;
+        block.view = glm::lookAt(eye, eye + front, glm::vec3(0.f, 1.f, 0.f));
+        block.projection = glm::perspective(glm::radians(45.f), float(kWidth) / float(kHeight), 0.1f, kExtent * 2.f);
+        block.viewProjection = block.projection * block.view;
+        block.position = glm::vec4(eye, 1.f);
+        return block;
+    }
+
+    int CullOnCpu(const std::vector<nether::GpuCullInstance>& instances, const nether::Frustum& frustum)
+    {
+        int visible = 0;
+        for (const nether::GpuCullInstance& instance : instances)
+        {
+            const glm::vec3 center(instance.model * glm::vec4(glm::vec3(instance.sphere), 1.f));
+            if (frustum.IntersectsSphere(center, instance.sphere.w))
+            {
+                visible++;
+            }
+        }
+        return visible;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const int cubes = argc > 1 ? atoi(argv[1]) : 262144;
+    if (cubes <= 0)
+    {
+        return EXIT_FAILURE;
+    }
+
+    nether::HeadlessContext ctx;
+    if (!ctx.Init(kWidth, kHeight))
+    {
+        return EXIT_FAILURE;
+    }
+
+    int result = EXIT_SUCCESS;
+    {
+        nether::GpuCuller culler;
+        if (!culler.Init())
+        {
+            ctx.Cleanup();
+            return EXIT_FAILURE;
+        }
+        nether::g_gpuProfiler.Init();
+
+        nether::ShaderProgram program;
+        program.LoadFromRawStrings(kVertexShader, kFragmentShader);
+        program.BindUniformBlock(nether::CameraBlock::Name, nether::CameraBlock::Binding);
+
+        // A cube and a flattened cube sharing one pool, indexed
+        const float corners[8][3] = {
+            { -.5f, -.5f, -.5f }, { .5f, -.5f, -.5f }, { .5f, .5f, -.5f }, { -.5f, .5f, -.5f },
+            { -.5f, -.5f, .5f }, { .5f, -.5f, .5f }, { .5f, .5f, .5f }, { -.5f, .5f, .5f }
+        };
+        const std::vector<unsigned int> indices = {
+            0, 2, 1, 0, 3, 2, 4, 5, 6, 4, 6, 7, 0, 4, 7, 0, 7, 3,
+            1, 2, 6, 1, 6, 5, 0, 1, 5, 0, 5, 4, 3, 7, 6, 3, 6, 2
+        };
+        nether::GeometryPool pool;
+        pool.Generate(3 * sizeof(float));
+        pool.AddVertexAttribute(0, 3, nether::GLType::Float, 0);
+
+        std::vector<nether::DrawElementsIndirectCommand> meshes;
+        for (int mesh = 0; mesh < kMeshes; mesh++)
+        {
+            std::vector<float> vertices;
+            for (const auto& corner : corners)
+            {
+                vertices.push_back(corner[0]);
+                vertices.push_back(mesh == 0 ? corner[1] : corner[1] * 0.25f);
+                vertices.push_back(corner[2]);
+            }
+            nether::PooledMesh pooled = pool.AddMesh(vertices, indices);
+
+            nether::DrawElementsIndirectCommand command;
+            command.count = (unsigned int)pooled.indexCount;
+            command.firstIndex = pooled.firstIndex;
+            command.baseVertex = pooled.baseVertex;
+            meshes.push_back(command);
+        }
+
+        std::mt19937 random(1234);
+        std::uniform_real_distribution<float> position(-kExtent, kExtent);
+        std::vector<nether::GpuCullInstance> instances(cubes);
+        for (nether::GpuCullInstance& instance : instances)
+        {
+            instance.model = glm::translate(glm::mat4(1.f), glm::vec3(position(random), position(random) * 0.25f, position(random)));
+            instance.sphere = glm::vec4(0.f, 0.f, 0.f, 0.87f);
+            instance.mesh = (unsigned int)(random() % kMeshes);
+        }
+        if (!culler.SetScene(meshes, instances))
+        {
+            culler.Shutdown();
+            ctx.Cleanup();
+            return EXIT_FAILURE;
+        }
+
+        nether::UniformBuffer<nether::CameraBlock> camera;
+        camera.Generate(nether::CameraBlock::Binding);
+
+        nether::gl::enable(GL_DEPTH_TEST);
+
+        double cpuCullMs = 0.0;
+        double gpuSubmitMs = 0.0;
+        long long cpuVisible = 0;
+        for (int frame = 0; frame < kFrames; frame++)
+        {
+            const nether::CameraBlock block = MakeCamera(frame);
+            const nether::Frustum frustum = nether::Frustum::FromMatrix(block.viewProjection);
+            camera.Upload(block);
+
+            double start = NowMs();
+            const int visible = CullOnCpu(instances, frustum);
+            cpuCullMs += NowMs() - start;
+            cpuVisible += visible;
+
+            nether::g_gpuProfiler.BeginFrame();
+            nether::gl::clear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+            start = NowMs();
+            {
+                NETHER_GPU_SCOPE("cull");
+                culler.Cull(frustum);
+            }
+            {
+                NETHER_GPU_SCOPE("draw");
+                program.Use();
+                nether::gl::bindVertexArray(pool.GetVAO());
+                culler.Draw(GL_TRIANGLES, GL_UNSIGNED_INT);
+            }
+            gpuSubmitMs += NowMs() - start;
+            nether::g_gpuProfiler.EndFrame();
+
+            if (frame == 0)
+            {
+                const int gpuVisible = culler.ReadVisibleCount();
+                printf("frame 0: %d visible on the cpu, %d on the gpu\n", visible, gpuVisible);
+                if (gpuVisible != visible)
+                {
+                    result = EXIT_FAILURE;
+                }
+            }
+            ctx.EndFrame();
+        }
+
+        printf("%d cubes, %lld visible on average, averaged over %d frames\n", cubes, cpuVisible / kFrames, kFrames);
+        printf("cpu cull   %8.3f ms\n", cpuCullMs / kFrames);
+        printf("gpu submit %8.3f ms cpu (cull + draw)\n", gpuSubmitMs / kFrames);
+        for (const nether::GpuScopeStats& scope : nether::g_gpuProfiler.GetScopeStats())
+        {
+            printf("gpu %-6s %8.3f ms avg %8.3f ms max\n", scope.name, scope.avgMs, scope.maxMs);
+        }
+
+        nether::g_gpuProfiler.Shutdown();
+        camera.Delete();
+        pool.Delete();
+        program.Delete();
+        culler.Shutdown();
+    }
+
+    ctx.Cleanup();
+    return result;
+}
@@ -0,0 +1,162 @@
+// Worst frame time while loading a batch of textures, loading them synchronously
+// with Texture::LoadFromFile versus through TextureLoader, uploading from client
+// memory ("direct") and through its pixel unpack staging buffer ("staged"). The
+// same images are then cooked to BC compressed .ntex files in the temp directory,
+// before timing, and loaded again both ways ("cooked").
+//
+// The batch is the images in media/ repeated; a frame is an Update plus a clear and
+// finish, so the synchronous case shows the whole batch as a single hitch while the
+// asynchronous one spreads the uploads over frames under the upload budget. Run
+// from the repository root. Runs on the headless context.
+//
+//  nether-bench-texture-load [copies of the media images, default 8] [upload budget in MB, default 16]
+#include <stdlib.h>
+#include <stdio.h>
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <nether/HeadlessContext.h>
+#include <nether/Texture.h>
+#include <nether/TextureCooker.h>
+#include <nether/TextureLoader.h>
+
+namespace
+{
+    constexpr int kWidth = 320;
+    constexpr int kHeight = 240;
+    constexpr double kTimeoutMs = 60000.0;
+
+    const char* kImages[] = {
+        "media/container.jpg",
+        "media/wall.jpg",
+        "media/awesomeface.png",
+        "media/spongebob.png"
+    };
+
+    double NowMs()
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void EndFrame(nether::HeadlessContext& ctx)
+    {
+        nether::gl::clear(GL_COLOR_BUFFER_BIT);
+        ctx.EndFrame();
+    }
+
+    bool RunSync(nether::HeadlessContext& ctx, const std::vector<std::string>& paths, const char* label)
+    {
+        bool loaded = true;
+        std::vector<nether::Texture> textures(paths.size());
+        const double start = NowMs();
+        for (size_t i = 0; i < paths.size(); i++)
+        {
+            loaded = textures[i].LoadFromFile(paths[i]) == 0 && loaded;
+        }
+        EndFrame(ctx);
+        printf("%-13s %3zu textures: 1 frame of %8.3f ms\n", label, paths.size(), NowMs() - start);
+        for (nether::Texture& texture : textures)
+        {
+            texture.Delete();
+        }
+        return loaded;
+    }
+
+    bool RunAsync(nether::HeadlessContext& ctx, const std::vector<std::string>& paths, long long budget, bool staged, const char* label)
+    {
+        nether::TextureLoader loader;
+        loader.Init(0, budget, staged);
+
+        const double start = NowMs();
+        std::vector<nether::TextureHandle> handles;
+        for (const std::string& path : paths)
+        {
+            handles.push_back(loader.Load(path));
+        }
+
+        double worstFrame = 0.0;
+        int frames = 0;
+        while (loader.GetPendingCount() > 0 && NowMs() - start < kTimeoutMs)
+        {
+            const double frameStart = NowMs();
+            loader.Update();
+            EndFrame(ctx);
+            const double frameMs = NowMs() - frameStart;
+            worstFrame = frameMs > worstFrame ? frameMs : worstFrame;
+            frames++;
+        }
+
+        const nether::TextureLoaderStats& stats = loader.GetStats();
+        printf("%-13s %3zu textures: %d frames, worst %8.3f ms, %8.3f ms total, %d workers, %llu uploaded (%llu staged), %llu failed, %llu deferred updates\n",
+            label, paths.size(), frames, worstFrame, NowMs() - start, loader.GetWorkerCount(),
+            stats.uploaded, stats.stagedUploads, stats.failed, stats.deferredUpdates);
+
+        for (nether::TextureHandle& handle : handles)
+        {
+            handle->GetTexture().Delete();
+        }
+        loader.Shutdown();
+        return stats.uploaded == paths.size();
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const int copies = argc > 1 ? atoi(argv[1]) : 8;
+    const long long budgetMb = argc > 2 ? atoll(argv[2]) : 16;
+    if (copies <= 0 || budgetMb <= 0)
+    {
+        return EXIT_FAILURE;
+    }
+
+    nether::HeadlessContext ctx;
+    if (!ctx.Init(kWidth, kHeight))
+    {
+        return EXIT_FAILURE;
+    }
+    // Frame times include the uploads' GPU work
+    ctx.SetFinishEachFrame(true);
+
+    // Cooked once per image, the copies share the file
+    const std::filesystem::path cookedDirectory = std::filesystem::temp_directory_path();
+    nether::TextureCookOptions cookOptions;
+    cookOptions.autoCompress = true;
+
+    int result = EXIT_SUCCESS;
+    std::vector<std::string> paths;
+    std::vector<std::string> cookedPaths;
+    for (int copy = 0; copy < copies; copy++)
+    {
+        for (const char* image : kImages)
+        {
+            const std::string cooked = (cookedDirectory / (std::filesystem::path(image).stem().string() + ".ntex")).string();
+            if (copy == 0 && !nether::TextureCooker::Cook(image, cooked, cookOptions))
+            {
+                result = EXIT_FAILURE;
+            }
+            paths.push_back(image);
+            cookedPaths.push_back(cooked);
+        }
+    }
+
+    const long long budget = budgetMb * 1024 * 1024;
+    if (!RunSync(ctx, paths, "sync") ||
+        !RunAsync(ctx, paths, budget, false, "direct") ||
+        !RunAsync(ctx, paths, budget, true, "staged") ||
+        !RunSync(ctx, cookedPaths, "cooked sync") ||
+        !RunAsync(ctx, cookedPaths, budget, true, "cooked staged"))
+    {
+        result = EXIT_FAILURE;
+    }
+
+    for (size_t i = 0; i < std::size(kImages); i++)
+    {
+        std::filesystem::remove(cookedPaths[i]);
+    }
+
+    ctx.Cleanup();
+    return result;
+}
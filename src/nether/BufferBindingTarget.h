@@ -7,7 +7,13 @@ namespace nether
     enum class BufferBindingTarget : GLenum
     {
         ArrayBuffer = GL_ARRAY_BUFFER,
-        ElementArrayBuffer = GL_ELEMENT_ARRAY_BUFFER
+        ElementArrayBuffer = GL_ELEMENT_ARRAY_BUFFER,
+        UniformBuffer = GL_UNIFORM_BUFFER,
+        DrawIndirectBuffer = GL_DRAW_INDIRECT_BUFFER,
+        ShaderStorageBuffer = GL_SHADER_STORAGE_BUFFER,
+        DispatchIndirectBuffer = GL_DISPATCH_INDIRECT_BUFFER,
+        PixelPackBuffer = GL_PIXEL_PACK_BUFFER,      // destination of readPixels/getTexImage
+        PixelUnpackBuffer = GL_PIXEL_UNPACK_BUFFER   // source of texImage2D/texSubImage2D
     };
 
 }
\ No newline at end of file
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <ranges>
+#include <span>
+#include <type_traits>
 #include <vector>
 
 #include "nether/BufferBindingTarget.h"
@@ -19,10 +22,142 @@ namespace nether
             nether::gl::genBuffers(1, &vbo);
         }
 
+        // Replaces the whole contents, the buffer must be bound. Storage is only
+        // reallocated when the data does not fit in the current capacity.
         template <typename T>
-        void UploadBufferData(const std::vector<T>& items)
+        void UploadBufferData(std::span<const std::type_identity_t<T>> items)
         {
-            nether::gl::bufferData(static_cast<GLenum>(bufferBindingTarget), sizeof(T) * items.size(), items.data(), GLenum(bufferUsage));
+            const long long bytes = static_cast<long long>(items.size_bytes());
+            if (bytes > capacity)
+            {
+                capacity = bytes;
+                nether::gl::bufferData(static_cast<GLenum>(bufferBindingTarget), bytes, items.data(), GLenum(bufferUsage));
+            }
+            else if (bytes > 0)
+            {
+                nether::gl::bufferSubData(static_cast<GLenum>(bufferBindingTarget), 0, bytes, items.data());
+            }
+            size = bytes;
+        }
+
+        // Any contiguous range: std::vector, std::array, C arrays, spans
+        template <typename Range>
+            requires std::ranges::contiguous_range<const Range&> && std::ranges::sized_range<const Range&>
+        void UploadBufferData(const Range& items)
+        {
+            UploadBufferData<std::ranges::range_value_t<Range>>(items);
+        }
+
+        // Overwrites the bytes starting at byteOffset with items, the buffer must be bound.
+        // Writing past the capacity grows the buffer, keeping the current contents.
+        template <typename T>
+        void UpdateRange(long long byteOffset, std::span<const std::type_identity_t<T>> items)
+        {
+            const long long bytes = static_cast<long long>(items.size_bytes());
+            if (byteOffset + bytes > capacity)
+            {
+                Reserve(byteOffset + bytes);
+            }
+            if (bytes > 0)
+            {
+                nether::gl::bufferSubData(static_cast<GLenum>(bufferBindingTarget), byteOffset, bytes, items.data());
+            }
+            if (byteOffset + bytes > size)
+            {
+                size = byteOffset + bytes;
+            }
+        }
+
+        template <typename Range>
+            requires std::ranges::contiguous_range<const Range&> && std::ranges::sized_range<const Range&>
+        void UpdateRange(long long byteOffset, const Range& items)
+        {
+            UpdateRange<std::ranges::range_value_t<Range>>(byteOffset, items);
+        }
+
+        // Makes room for at least bytes, growing geometrically and keeping the used contents
+        void Reserve(long long bytes)
+        {
+            if (bytes <= capacity)
+            {
+                return;
+            }
+
+            long long newCapacity = capacity * 2;
+            if (newCapacity < bytes)
+            {
+                newCapacity = bytes;
+            }
+
+            if (size == 0)
+            {
+                nether::gl::bufferData(static_cast<GLenum>(bufferBindingTarget), newCapacity, nullptr, GLenum(bufferUsage));
+                capacity = newCapacity;
+                return;
+            }
+
+            // The buffer name has to survive the growth since VAOs reference it, so the used
+            // bytes take a round trip through a scratch buffer instead of swapping buffers.
+            unsigned int scratch = 0;
+            nether::gl::genBuffers(1, &scratch);
+            nether::gl::bindBuffer(GL_COPY_WRITE_BUFFER, scratch);
+            nether::gl::bufferData(GL_COPY_WRITE_BUFFER, size, nullptr, GL_STREAM_COPY);
+            nether::gl::bindBuffer(GL_COPY_READ_BUFFER, vbo);
+            nether::gl::copyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, size);
+
+            nether::gl::bufferData(GL_COPY_READ_BUFFER, newCapacity, nullptr, GLenum(bufferUsage));
+            nether::gl::bindBuffer(GL_COPY_READ_BUFFER, scratch);
+            nether::gl::bindBuffer(GL_COPY_WRITE_BUFFER, vbo);
+            nether::gl::copyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, size);
+
+            nether::gl::deleteBuffers(1, &scratch);
+            capacity = newCapacity;
+        }
+
+        // Allocates size bytes of uninitialized storage, the buffer must be bound
+        void Allocate(long long bytes)
+        {
+            nether::gl::bufferData(static_cast<GLenum>(bufferBindingTarget), bytes, nullptr, GLenum(bufferUsage));
+            capacity = bytes;
+            size = 0;
+        }
+
+        // Overwrites size bytes at offset, the buffer must be bound
+        void UploadBufferSubData(long long offset, const void* data, long long bytes)
+        {
+            nether::gl::bufferSubData(static_cast<GLenum>(bufferBindingTarget), offset, bytes, data);
+            if (offset + bytes > size)
+            {
+                size = offset + bytes;
+            }
+        }
+
+        // Bytes of storage allocated on the GPU
+        long long GetCapacity() const
+        {
+            return capacity;
+        }
+
+        // Bytes written so far (high water mark)
+        long long GetSize() const
+        {
+            return size;
+        }
+
+        // Binds the buffer to an indexed binding point (uniform/storage buffers)
+        void BindBase(unsigned int index)
+        {
+            nether::gl::bindBufferBase(static_cast<GLenum>(bufferBindingTarget), index, vbo);
+        }
+
+        void BindRange(unsigned int index, long long offset, long long size)
+        {
+            nether::gl::bindBufferRange(static_cast<GLenum>(bufferBindingTarget), index, vbo, offset, size);
+        }
+
+        unsigned int GetBufferObject() const
+        {
+            return vbo;
         }
 
         void Bind()
@@ -38,6 +173,8 @@ namespace nether
         void Delete()
         {
             nether::gl::deleteBuffers(1, &vbo);
+            capacity = 0;
+            size = 0;
         }
 
     private:
@@ -55,6 +192,8 @@ namespace nether
         BufferUsage bufferUsage = BufferUsage::StaticDraw;
         BufferBindingTarget bufferBindingTarget = BufferBindingTarget::ArrayBuffer;
         unsigned int vbo = 0;
+        long long capacity = 0;
+        long long size = 0;
 
     };
 
@@ -0,0 +1,203 @@
+#pragma once
+
+#include "nether/NetherGL.h"
+#include "nether/StreamingBuffer.h"
+
+#include <glm/glm.hpp>
+
+#include <type_traits>
+#include <vector>
+
+namespace nether
+{
+
+    // Everything needed to issue one draw, as plain GL names and numbers so packets
+    // can be recorded on any thread, copied around and sorted without touching GL.
+    // Textures are bound to units 0..kMaxTextures-1, a 0 name leaves the unit alone.
+    // When uniformBuffer is set, [uniformOffset, uniformOffset + uniformSize) of it
+    // is bound to uniformBinding, typically a StreamingBuffer allocation holding the
+    // per draw block (model matrix...).
+    // Packets with a transform are drawn instanced instead, see Renderer::Submit.
+    struct DrawPacket
+    {
+        static constexpr int kMaxTextures = 4;
+        static constexpr unsigned int kNoTransform = 0xFFFFFFFF;
+
+        unsigned int program = 0;
+        unsigned int vao = 0;
+        unsigned int textures[kMaxTextures] = {};
+
+        unsigned int uniformBuffer = 0;
+        unsigned int uniformBinding = 0;
+        long long uniformOffset = 0;
+        long long uniformSize = 0;
+
+        unsigned int primitive = GL_TRIANGLES;
+        // 0 for non indexed draws, otherwise GL_UNSIGNED_SHORT/GL_UNSIGNED_INT
+        unsigned int indexType = 0;
+        // first vertex for array draws, byte offset into the index buffer otherwise
+        long long first = 0;
+        int count = 0;
+        int instanceCount = 1;
+        int baseVertex = 0;
+        unsigned int baseInstance = 0;
+
+        // Index into the CommandBuffer's transforms, or kNoTransform
+        unsigned int transform = kNoTransform;
+
+        // Order used by Renderer::SubmitSorted, see SortKey
+        unsigned long long sortKey = 0;
+    };
+
+    static_assert(std::is_trivially_copyable_v<DrawPacket>, "DrawPacket must stay POD");
+
+    // List of draw packets for one frame or pass. Recording only appends to a
+    // vector; nothing reaches GL until Renderer::Submit walks the packets, in
+    // recording order, or Renderer::SubmitSorted, in sort key order.
+    //
+    //  commands.Clear();
+    //  auto perDraw = streaming.Allocate(sizeof(glm::mat4), uboAlignment);
+    //  memcpy(perDraw.data, &model, sizeof(glm::mat4));
+    //  commands.DrawArrays(program.GetProgram(), vao.GetVAO(), GL_TRIANGLES, 0, 36)
+    //      .SetTexture(0, tex.GetTextureID())
+    //      .SetUniformRange(1, streaming, perDraw);
+    //  renderer.BeginFrame();
+    //  renderer.Submit(commands);
+    //  renderer.EndFrame();
+    class CommandBuffer
+    {
+    public:
+        // Returned by the Draw* helpers to fill in the optional parts of a packet
+        class PacketBuilder
+        {
+        public:
+            PacketBuilder(DrawPacket& packet, std::vector<glm::mat4>& transforms) : m_packet(packet)
+                , m_transforms(transforms)
+            {}
+
+            PacketBuilder& SetTexture(int unit, unsigned int texture)
+            {
+                m_packet.textures[unit] = texture;
+                return *this;
+            }
+
+            PacketBuilder& SetUniformRange(unsigned int binding, unsigned int buffer, long long offset, long long size)
+            {
+                m_packet.uniformBinding = binding;
+                m_packet.uniformBuffer = buffer;
+                m_packet.uniformOffset = offset;
+                m_packet.uniformSize = size;
+                return *this;
+            }
+
+            PacketBuilder& SetUniformRange(unsigned int binding, const StreamingBuffer& buffer, const StreamingAllocation& allocation)
+            {
+                return SetUniformRange(binding, buffer.GetBufferObject(), allocation.offset, allocation.size);
+            }
+
+            // Per instance model matrix, read by the vertex shader as a mat4 attribute
+            // at Renderer::kInstanceTransformLocation
+            PacketBuilder& SetTransform(const glm::mat4& transform)
+            {
+                m_packet.transform = (unsigned int)m_transforms.size();
+                m_transforms.push_back(transform);
+                return *this;
+            }
+
+            PacketBuilder& SetSortKey(unsigned long long key)
+            {
+                m_packet.sortKey = key;
+                return *this;
+            }
+
+            PacketBuilder& SetInstances(int instanceCount, unsigned int baseInstance = 0)
+            {
+                m_packet.instanceCount = instanceCount;
+                m_packet.baseInstance = baseInstance;
+                return *this;
+            }
+
+            DrawPacket& GetPacket()
+            {
+                return m_packet;
+            }
+
+        private:
+            DrawPacket& m_packet;
+            std::vector<glm::mat4>& m_transforms;
+        };
+
+        void Reserve(size_t packetCount)
+        {
+            m_packets.reserve(packetCount);
+        }
+
+        void Clear()
+        {
+            m_packets.clear();
+            m_transforms.clear();
+        }
+
+        // A transform index in packet must refer to this buffer's transforms
+        PacketBuilder Add(const DrawPacket& packet)
+        {
+            m_packets.push_back(packet);
+            return PacketBuilder(m_packets.back(), m_transforms);
+        }
+
+        PacketBuilder DrawArrays(unsigned int program, unsigned int vao, unsigned int primitive, int first, int count)
+        {
+            DrawPacket packet;
+            packet.program = program;
+            packet.vao = vao;
+            packet.primitive = primitive;
+            packet.first = first;
+            packet.count = count;
+            return Add(packet);
+        }
+
+        PacketBuilder DrawElements(unsigned int program, unsigned int vao, unsigned int primitive, int count,
+            unsigned int indexType, long long indexByteOffset = 0, int baseVertex = 0)
+        {
+            DrawPacket packet;
+            packet.program = program;
+            packet.vao = vao;
+            packet.primitive = primitive;
+            packet.indexType = indexType;
+            packet.first = indexByteOffset;
+            packet.count = count;
+            packet.baseVertex = baseVertex;
+            return Add(packet);
+        }
+
+        const std::vector<DrawPacket>& GetPackets() const
+        {
+            return m_packets;
+        }
+
+        std::vector<DrawPacket>& GetPackets()
+        {
+            return m_packets;
+        }
+
+        const std::vector<glm::mat4>& GetTransforms() const
+        {
+            return m_transforms;
+        }
+
+        size_t Size() const
+        {
+            return m_packets.size();
+        }
+
+        bool IsEmpty() const
+        {
+            return m_packets.empty();
+        }
+
+    private:
+        std::vector<DrawPacket> m_packets;
+        std::vector<glm::mat4> m_transforms;
+    };
+
+}
@@ -0,0 +1,172 @@
+#pragma once
+
+#include "nether/ShaderProgram.h"
+
+#include <glm/glm.hpp>
+
+#include <stdio.h>
+#include <string>
+
+namespace nether
+{
+
+    // Layout dispatchComputeIndirect reads from GL_DISPATCH_INDIRECT_BUFFER
+    struct DispatchIndirectCommand
+    {
+        unsigned int groupsX = 1;
+        unsigned int groupsY = 1;
+        unsigned int groupsZ = 1;
+    };
+
+    static_assert(sizeof(DispatchIndirectCommand) == 12, "DispatchIndirectCommand must match the GL layout");
+
+    // Program with a single compute stage. The work group size declared in the shader
+    // (layout (local_size_x = ...) in;) is read back after linking, so callers can
+    // dispatch by number of invocations and the shader stays the only place the
+    // size is written down.
+    //
+    //  compute.LoadFromRawString(code);
+    //  compute.Use();
+    //  compute.GetShaderProgram().SetIntUniform("count", count);
+    //  particles.BindBase(0);
+    //  compute.DispatchInvocations(count);
+    //  ComputeProgram::Barrier(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
+    //
+    // Requires GL 4.3.
+    class ComputeProgram
+    {
+    public:
+        void Load(const std::string& computeShaderFile)
+        {
+            m_program.LoadCompute(computeShaderFile);
+            Introspect();
+        }
+
+        void LoadFromRawString(const std::string& computeShaderCode)
+        {
+            m_program.LoadComputeFromRawString(computeShaderCode);
+            Introspect();
+        }
+
+        void Delete()
+        {
+            m_program.Delete();
+            m_workGroupSize = glm::ivec3(0, 0, 0);
+        }
+
+        // False when compiling or linking failed, see the compilation infos
+        bool IsValid() const
+        {
+            return m_program.GetProgram() != 0 && !m_program.GetComputeShaderCompilationInfo().hasError
+                && !m_program.GetShaderProgramCompilationInfo().hasError;
+        }
+
+        void Use()
+        {
+            m_program.Use();
+        }
+
+        // Runs groupsX * groupsY * groupsZ work groups, the program must be in use.
+        // Prints why and returns false, dispatching nothing, if a count is above
+        // GL_MAX_COMPUTE_WORK_GROUP_COUNT; bigger jobs have to be split by the caller,
+        // see GetMaxWorkGroupCount.
+        bool Dispatch(unsigned int groupsX, unsigned int groupsY = 1, unsigned int groupsZ = 1)
+        {
+            if (groupsX == 0 || groupsY == 0 || groupsZ == 0)
+            {
+                return true;
+            }
+
+            const unsigned int groups[3] = { groupsX, groupsY, groupsZ };
+            for (int axis = 0; axis < 3; axis++)
+            {
+                if (groups[axis] > GetMaxWorkGroupCount(axis))
+                {
+                    printf("ComputeProgram: %u work groups on axis %d, the limit is %u\n", groups[axis], axis, GetMaxWorkGroupCount(axis));
+                    return false;
+                }
+            }
+            nether::gl::dispatchCompute(groupsX, groupsY, groupsZ);
+            return true;
+        }
+
+        // Enough work groups to cover the given number of invocations on each axis.
+        // The shader has to skip the invocations past the end of the last group.
+        bool DispatchInvocations(unsigned int countX, unsigned int countY = 1, unsigned int countZ = 1)
+        {
+            return Dispatch(GroupsFor(countX, 0), GroupsFor(countY, 1), GroupsFor(countZ, 2));
+        }
+
+        // Reads a DispatchIndirectCommand at byteOffset in the buffer bound to
+        // GL_DISPATCH_INDIRECT_BUFFER, so the GPU can size its own work
+        void DispatchIndirect(long long byteOffset = 0)
+        {
+            nether::gl::dispatchComputeIndirect(byteOffset);
+        }
+
+        // Makes the writes of earlier dispatches visible to what barriers names
+        // (GL_SHADER_STORAGE_BARRIER_BIT, GL_COMMAND_BARRIER_BIT...)
+        static void Barrier(unsigned int barriers)
+        {
+            nether::gl::memoryBarrier(barriers);
+        }
+
+        unsigned int GroupsFor(unsigned int invocations, int axis) const
+        {
+            const unsigned int size = (unsigned int)m_workGroupSize[axis];
+            return size == 0 ? 0 : (invocations + size - 1) / size;
+        }
+
+        // local_size_x/y/z of the shader, 0 when the program did not link
+        const glm::ivec3& GetWorkGroupSize() const
+        {
+            return m_workGroupSize;
+        }
+
+        int GetWorkGroupInvocations() const
+        {
+            return m_workGroupSize.x * m_workGroupSize.y * m_workGroupSize.z;
+        }
+
+        // GL_MAX_COMPUTE_WORK_GROUP_COUNT on the given axis, at least 65535
+        unsigned int GetMaxWorkGroupCount(int axis) const
+        {
+            return (unsigned int)m_maxWorkGroupCount[axis];
+        }
+
+        // For uniforms, uniform blocks and compilation infos
+        ShaderProgram& GetShaderProgram()
+        {
+            return m_program;
+        }
+
+        const ShaderProgram& GetShaderProgram() const
+        {
+            return m_program;
+        }
+
+    private:
+        void Introspect()
+        {
+            m_workGroupSize = glm::ivec3(0, 0, 0);
+            if (!IsValid())
+            {
+                return;
+            }
+
+            int size[3] = {};
+            nether::gl::getProgramiv(m_program.GetProgram(), GL_COMPUTE_WORK_GROUP_SIZE, size);
+            m_workGroupSize = glm::ivec3(size[0], size[1], size[2]);
+
+            for (unsigned int axis = 0; axis < 3; axis++)
+            {
+                nether::gl::getIntegeri_v(GL_MAX_COMPUTE_WORK_GROUP_COUNT, axis, &m_maxWorkGroupCount[axis]);
+            }
+        }
+
+        ShaderProgram m_program;
+        glm::ivec3 m_workGroupSize = glm::ivec3(0, 0, 0);
+        int m_maxWorkGroupCount[3] = { 65535, 65535, 65535 };
+    };
+
+}
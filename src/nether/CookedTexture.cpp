@@ -0,0 +1,258 @@
+#include "CookedTexture.h"
+
+#include "nether/Texture.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace nether {
+
+	namespace {
+
+		unsigned long long AlignUp(unsigned long long value, unsigned long long alignment)
+		{
+			return (value + alignment - 1) / alignment * alignment;
+		}
+
+		const char* Validate(const CookedTextureHeader& header, size_t fileSize)
+		{
+			if (header.magic != CookedTextureHeader::kMagic)
+			{
+				return "not a cooked texture";
+			}
+			if (header.version != CookedTextureHeader::kVersion)
+			{
+				return "cooked with another version, cook it again";
+			}
+			if (header.format > unsigned(TextureFormat::BC7) || header.width == 0 || header.height == 0 ||
+				header.width > unsigned(Texture::kMaxSize) || header.height > unsigned(Texture::kMaxSize))
+			{
+				return "bad format or size";
+			}
+			if (header.levelCount == 0 || header.levelCount > unsigned(CookedTextureHeader::kMaxLevels) ||
+				header.levelCount > unsigned(Texture::GetMipLevelCount(int(header.width), int(header.height))))
+			{
+				return "bad level count";
+			}
+
+			for (unsigned int i = 0; i < header.levelCount; i++)
+			{
+				const CookedTextureLevel& level = header.levels[i];
+				const unsigned int width = header.width >> i > 0 ? header.width >> i : 1;
+				const unsigned int height = header.height >> i > 0 ? header.height >> i : 1;
+				if (level.width != width || level.height != height ||
+					level.size != (unsigned long long)TextureFormatUtils::GetImageSize(TextureFormat(header.format), int(width), int(height)) ||
+					level.offset % CookedTextureHeader::kLevelAlignment != 0 ||
+					level.offset > fileSize || fileSize - level.offset < level.size)
+				{
+					return "bad or truncated level";
+				}
+			}
+			return nullptr;
+		}
+
+	}
+
+	CookedTexture::CookedTexture(CookedTexture&& other) noexcept
+	{
+		*this = std::move(other);
+	}
+
+	CookedTexture& CookedTexture::operator=(CookedTexture&& other) noexcept
+	{
+		if (this != &other)
+		{
+			Close();
+			m_mapping = other.m_mapping;
+			m_header = other.m_header;
+			m_size = other.m_size;
+			other.m_mapping = nullptr;
+			other.m_header = nullptr;
+			other.m_size = 0;
+#ifdef _WIN32
+			m_file = other.m_file;
+			m_fileMapping = other.m_fileMapping;
+			other.m_file = nullptr;
+			other.m_fileMapping = nullptr;
+#endif
+		}
+		return *this;
+	}
+
+	bool CookedTexture::IsCookedFile(const std::string& filePath)
+	{
+		return filePath.size() >= 5 && filePath.compare(filePath.size() - 5, 5, ".ntex") == 0;
+	}
+
+	bool CookedTexture::Write(const std::string& filePath, TextureFormat format, int width, int height, unsigned int flags,
+		const std::vector<std::vector<unsigned char>>& levels)
+	{
+		if (levels.empty() || levels.size() > size_t(CookedTextureHeader::kMaxLevels))
+		{
+			printf("CookedTexture: %s: %zu levels, expected 1 to %d\n", filePath.c_str(), levels.size(), CookedTextureHeader::kMaxLevels);
+			return false;
+		}
+
+		CookedTextureHeader header;
+		header.format = unsigned(format);
+		header.flags = flags;
+		header.width = unsigned(width);
+		header.height = unsigned(height);
+		header.levelCount = unsigned(levels.size());
+
+		unsigned long long offset = AlignUp(sizeof(header), CookedTextureHeader::kLevelAlignment);
+		for (size_t i = 0; i < levels.size(); i++)
+		{
+			CookedTextureLevel& level = header.levels[i];
+			level.offset = offset;
+			level.size = levels[i].size();
+			level.width = header.width >> i > 0 ? header.width >> i : 1;
+			level.height = header.height >> i > 0 ? header.height >> i : 1;
+			offset = AlignUp(offset + level.size, CookedTextureHeader::kLevelAlignment);
+		}
+
+		const char* error = Validate(header, size_t(offset));
+		if (error != nullptr)
+		{
+			printf("CookedTexture: %s: %s\n", filePath.c_str(), error);
+			return false;
+		}
+
+		FILE* file = fopen(filePath.c_str(), "wb");
+		if (file == nullptr)
+		{
+			printf("CookedTexture: could not write %s\n", filePath.c_str());
+			return false;
+		}
+
+		static const unsigned char kPadding[CookedTextureHeader::kLevelAlignment] = {};
+		bool written = fwrite(&header, sizeof(header), 1, file) == 1;
+		unsigned long long position = sizeof(header);
+		for (size_t i = 0; i < levels.size() && written; i++)
+		{
+			const size_t padding = size_t(header.levels[i].offset - position);
+			written = fwrite(kPadding, 1, padding, file) == padding &&
+				fwrite(levels[i].data(), 1, levels[i].size(), file) == levels[i].size();
+			position = header.levels[i].offset + header.levels[i].size;
+		}
+		written = fclose(file) == 0 && written;
+
+		if (!written)
+		{
+			printf("CookedTexture: could not write %s\n", filePath.c_str());
+		}
+		return written;
+	}
+
+	bool CookedTexture::Open(const std::string& filePath)
+	{
+		Close();
+
+#ifdef _WIN32
+		HANDLE file = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		LARGE_INTEGER size = {};
+		if (file == INVALID_HANDLE_VALUE || !GetFileSizeEx(file, &size) || size.QuadPart == 0)
+		{
+			if (file != INVALID_HANDLE_VALUE)
+			{
+				CloseHandle(file);
+			}
+			printf("CookedTexture: could not read %s\n", filePath.c_str());
+			return false;
+		}
+		HANDLE fileMapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		void* mapping = fileMapping != nullptr ? MapViewOfFile(fileMapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+		if (mapping == nullptr)
+		{
+			if (fileMapping != nullptr)
+			{
+				CloseHandle(fileMapping);
+			}
+			CloseHandle(file);
+			printf("CookedTexture: could not map %s\n", filePath.c_str());
+			return false;
+		}
+		m_file = file;
+		m_fileMapping = fileMapping;
+		m_size = size_t(size.QuadPart);
+#else
+		const int file = open(filePath.c_str(), O_RDONLY);
+		struct stat status = {};
+		if (file < 0 || fstat(file, &status) != 0 || status.st_size == 0)
+		{
+			if (file >= 0)
+			{
+				close(file);
+			}
+			printf("CookedTexture: could not read %s\n", filePath.c_str());
+			return false;
+		}
+		// The mapping keeps its own reference to the file
+		void* mapping = mmap(nullptr, size_t(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+		close(file);
+		if (mapping == MAP_FAILED)
+		{
+			printf("CookedTexture: could not map %s\n", filePath.c_str());
+			return false;
+		}
+		m_size = size_t(status.st_size);
+#endif
+
+		m_mapping = static_cast<const unsigned char*>(mapping);
+		m_header = reinterpret_cast<const CookedTextureHeader*>(m_mapping);
+
+		const char* error = m_size < sizeof(CookedTextureHeader) ? "truncated header" : Validate(*m_header, m_size);
+		if (error != nullptr)
+		{
+			printf("CookedTexture: %s: %s\n", filePath.c_str(), error);
+			Close();
+			return false;
+		}
+		return true;
+	}
+
+	void CookedTexture::Close()
+	{
+		if (m_mapping == nullptr)
+		{
+			return;
+		}
+
+#ifdef _WIN32
+		UnmapViewOfFile(m_mapping);
+		CloseHandle(m_fileMapping);
+		CloseHandle(m_file);
+		m_file = nullptr;
+		m_fileMapping = nullptr;
+#else
+		munmap(const_cast<unsigned char*>(m_mapping), m_size);
+#endif
+		m_mapping = nullptr;
+		m_header = nullptr;
+		m_size = 0;
+	}
+
+	void CookedTexture::Prefetch() const
+	{
+		// One read per page faults the whole file in
+		const size_t kPageSize = 4096;
+		volatile unsigned char sink = 0;
+		for (size_t offset = 0; offset < m_size; offset += kPageSize)
+		{
+			sink = sink + m_mapping[offset];
+		}
+	}
+
+}
@@ -0,0 +1,141 @@
+#pragma once
+
+#include "nether/TextureFormat.h"
+
+#include <bit>
+#include <stddef.h>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace nether
+{
+
+    enum CookedTextureFlags : unsigned int
+    {
+        kCookedTexturePremultiplied = 1 << 0
+    };
+
+    struct CookedTextureLevel
+    {
+        unsigned long long offset = 0;
+        unsigned long long size = 0;
+        unsigned int width = 0;
+        unsigned int height = 0;
+    };
+
+    // Start of a .ntex file, little endian. Level data follows, each level starting
+    // on a kLevelAlignment boundary, so a mapped file can be uploaded level by level
+    // straight from the mapping. format holds a TextureFormat value; reordering that
+    // enum needs a new kVersion.
+    struct CookedTextureHeader
+    {
+        static constexpr unsigned int kMagic = 0x5845544E; // "NTEX"
+        static constexpr unsigned int kVersion = 1;
+        static constexpr int kMaxLevels = 16;
+        static constexpr unsigned long long kLevelAlignment = 64;
+
+        unsigned int magic = kMagic;
+        unsigned int version = kVersion;
+        unsigned int format = 0;
+        unsigned int flags = 0;
+        unsigned int width = 0;
+        unsigned int height = 0;
+        unsigned int levelCount = 0;
+        unsigned int reserved = 0;
+        CookedTextureLevel levels[kMaxLevels];
+    };
+
+    static_assert(std::is_trivially_copyable_v<CookedTextureHeader>, "CookedTextureHeader is written as is");
+    static_assert(sizeof(CookedTextureHeader) == 32 + CookedTextureHeader::kMaxLevels * 24, "CookedTextureHeader layout changed");
+    // Files are read and written without byte swapping
+    static_assert(std::endian::native == std::endian::little, ".ntex files are little endian");
+
+    // Texture cooked offline by TextureCooker (nether-texcook) into the GPU format,
+    // mip chain included. Open memory maps the file, so loading one does no decoding
+    // and no copying: Texture::Create(const CookedTexture&) uploads from the mapping.
+    //
+    //  nether::CookedTexture cooked;
+    //  if (cooked.Open("media/wall.ntex")) texture.Create(cooked);
+    //
+    // Pages are read from disk as they are first touched; Prefetch reads them all up
+    // front, to keep that I/O off the thread that uploads.
+    class CookedTexture
+    {
+    public:
+        CookedTexture() = default;
+        CookedTexture(const CookedTexture&) = delete;
+        CookedTexture& operator=(const CookedTexture&) = delete;
+        CookedTexture(CookedTexture&& other) noexcept;
+        CookedTexture& operator=(CookedTexture&& other) noexcept;
+
+        ~CookedTexture()
+        {
+            Close();
+        }
+
+        // By extension, .ntex
+        static bool IsCookedFile(const std::string& filePath);
+
+        // levels[i] holds level i, already in format. Returns false when the file can't
+        // be written.
+        static bool Write(const std::string& filePath, TextureFormat format, int width, int height, unsigned int flags,
+            const std::vector<std::vector<unsigned char>>& levels);
+
+        // Maps and validates the file. Prints why and returns false on failure.
+        bool Open(const std::string& filePath);
+        void Close();
+
+        void Prefetch() const;
+
+        bool IsOpen() const
+        {
+            return m_mapping != nullptr;
+        }
+
+        TextureFormat GetFormat() const
+        {
+            return TextureFormat(m_header->format);
+        }
+
+        int GetWidth() const
+        {
+            return int(m_header->width);
+        }
+
+        int GetHeight() const
+        {
+            return int(m_header->height);
+        }
+
+        int GetLevelCount() const
+        {
+            return int(m_header->levelCount);
+        }
+
+        const CookedTextureLevel& GetLevel(int level) const
+        {
+            return m_header->levels[level];
+        }
+
+        const unsigned char* GetLevelData(int level) const
+        {
+            return m_mapping + m_header->levels[level].offset;
+        }
+
+        bool IsPremultiplied() const
+        {
+            return (m_header->flags & kCookedTexturePremultiplied) != 0;
+        }
+
+    private:
+        const unsigned char* m_mapping = nullptr;
+        const CookedTextureHeader* m_header = nullptr;
+        size_t m_size = 0;
+#ifdef _WIN32
+        void* m_file = nullptr;
+        void* m_fileMapping = nullptr;
+#endif
+    };
+
+}
@@ -0,0 +1,221 @@
+#include "CpuProfiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <stdio.h>
+
+namespace nether {
+
+	CpuProfiler& g_cpuProfiler = CpuProfiler::Instance();
+
+	thread_local int CpuScope::s_depth = 0;
+
+	namespace {
+
+		void WriteEscaped(FILE* file, const char* text)
+		{
+			for (const char* c = text; *c != '\0'; c++)
+			{
+				if (*c == '"' || *c == '\\')
+				{
+					fputc('\\', file);
+				}
+				fputc(*c, file);
+			}
+		}
+
+		void WriteEvent(FILE* file, bool& first, const char* name, const char* category,
+			long long beginNs, long long endNs, int threadId)
+		{
+			fprintf(file, "%s\n{\"name\":\"", first ? "" : ",");
+			WriteEscaped(file, name);
+			fprintf(file, "\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+				category, threadId, beginNs * 1e-3, (endNs - beginNs) * 1e-3);
+			first = false;
+		}
+
+		void WriteThreadName(FILE* file, bool& first, int threadId, const char* name)
+		{
+			fprintf(file, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+				first ? "" : ",", threadId, name);
+			first = false;
+		}
+
+	}
+
+	CpuProfiler& CpuProfiler::Instance()
+	{
+		static CpuProfiler profiler;
+		return profiler;
+	}
+
+	long long CpuProfiler::Now()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	void CpuProfiler::Record(const char* name, long long beginNs, long long endNs, int depth)
+	{
+		ThreadBuffer& buffer = GetThreadBuffer();
+
+		// Single producer: only this thread moves head, EndFrame only moves tail
+		unsigned long long head = buffer.head.load(std::memory_order_relaxed);
+		unsigned long long tail = buffer.tail.load(std::memory_order_acquire);
+		if (head - tail >= kThreadBufferSize)
+		{
+			buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+
+		CpuEvent& event = buffer.events[head % kThreadBufferSize];
+		event.name = name;
+		event.beginNs = beginNs;
+		event.endNs = endNs;
+		event.threadId = buffer.threadId;
+		event.depth = depth;
+		buffer.head.store(head + 1, std::memory_order_release);
+	}
+
+	void CpuProfiler::EndFrame()
+	{
+		m_lastFrameEvents.clear();
+
+		std::lock_guard<std::mutex> lock(m_threadsMutex);
+		for (const std::unique_ptr<ThreadBuffer>& buffer : m_threads)
+		{
+			unsigned long long tail = buffer->tail.load(std::memory_order_relaxed);
+			unsigned long long head = buffer->head.load(std::memory_order_acquire);
+			for (; tail != head; tail++)
+			{
+				m_lastFrameEvents.push_back(buffer->events[tail % kThreadBufferSize]);
+			}
+			buffer->tail.store(tail, std::memory_order_release);
+		}
+
+		if (m_capture)
+		{
+			m_capturedEvents.insert(m_capturedEvents.end(), m_lastFrameEvents.begin(), m_lastFrameEvents.end());
+		}
+	}
+
+	std::vector<CpuEvent> CpuProfiler::TakeCapturedEvents()
+	{
+		std::vector<CpuEvent> events;
+		events.swap(m_capturedEvents);
+		return events;
+	}
+
+	unsigned long long CpuProfiler::GetDroppedEvents() const
+	{
+		std::lock_guard<std::mutex> lock(m_threadsMutex);
+		unsigned long long dropped = 0;
+		for (const std::unique_ptr<ThreadBuffer>& buffer : m_threads)
+		{
+			dropped += buffer->dropped.load(std::memory_order_relaxed);
+		}
+		return dropped;
+	}
+
+	bool CpuProfiler::WriteChromeTrace(const std::string& path, GpuProfiler& gpuProfiler)
+	{
+		std::vector<CpuEvent> cpuEvents = TakeCapturedEvents();
+		std::vector<GpuEvent> gpuEvents = gpuProfiler.TakeCapturedEvents();
+		const long long gpuOffset = gpuProfiler.GetClockOffset();
+
+		// Timestamps are written relative to the first event to keep them readable
+		long long origin = 0;
+		bool hasOrigin = false;
+		for (const CpuEvent& event : cpuEvents)
+		{
+			origin = hasOrigin ? std::min(origin, event.beginNs) : event.beginNs;
+			hasOrigin = true;
+		}
+		for (const GpuEvent& event : gpuEvents)
+		{
+			origin = hasOrigin ? std::min(origin, event.beginNs + gpuOffset) : event.beginNs + gpuOffset;
+			hasOrigin = true;
+		}
+
+		FILE* file = fopen(path.c_str(), "w");
+		if (file == nullptr)
+		{
+			printf("Could not write trace %s\n", path.c_str());
+			return false;
+		}
+
+		// GPU events go on their own track, tid 0; CPU threads are numbered from 1
+		const int gpuThreadId = 0;
+		int threadCount = 0;
+		{
+			std::lock_guard<std::mutex> lock(m_threadsMutex);
+			threadCount = int(m_threads.size());
+		}
+
+		bool first = true;
+		fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+		WriteThreadName(file, first, gpuThreadId, "GPU");
+		for (int thread = 1; thread <= threadCount; thread++)
+		{
+			char name[32];
+			snprintf(name, sizeof(name), "CPU %d", thread);
+			WriteThreadName(file, first, thread, name);
+		}
+		for (const CpuEvent& event : cpuEvents)
+		{
+			WriteEvent(file, first, event.name, "cpu", event.beginNs - origin, event.endNs - origin, event.threadId);
+		}
+		for (const GpuEvent& event : gpuEvents)
+		{
+			WriteEvent(file, first, event.name, "gpu", event.beginNs + gpuOffset - origin, event.endNs + gpuOffset - origin, gpuThreadId);
+		}
+		fprintf(file, "\n]}\n");
+		fclose(file);
+
+		printf("Wrote %zu cpu and %zu gpu events to %s\n", cpuEvents.size(), gpuEvents.size(), path.c_str());
+		return true;
+	}
+
+	CpuProfiler::ThreadBuffer& CpuProfiler::GetThreadBuffer()
+	{
+		// Hands the ring back when the thread exits
+		struct ThreadBufferOwner
+		{
+			ThreadBuffer* buffer = nullptr;
+
+			~ThreadBufferOwner()
+			{
+				if (buffer != nullptr)
+				{
+					buffer->exited.store(true, std::memory_order_release);
+				}
+			}
+		};
+
+		thread_local ThreadBufferOwner owner;
+		if (owner.buffer == nullptr)
+		{
+			// Buffers are owned by the profiler so events survive the thread exiting
+			std::lock_guard<std::mutex> lock(m_threadsMutex);
+			for (const std::unique_ptr<ThreadBuffer>& buffer : m_threads)
+			{
+				// EndFrame drains under the same lock, an exited thread records no more
+				if (buffer->exited.load(std::memory_order_acquire) &&
+					buffer->tail.load(std::memory_order_relaxed) == buffer->head.load(std::memory_order_relaxed))
+				{
+					buffer->exited.store(false, std::memory_order_relaxed);
+					owner.buffer = buffer.get();
+					break;
+				}
+			}
+			if (owner.buffer == nullptr)
+			{
+				m_threads.push_back(std::make_unique<ThreadBuffer>());
+				owner.buffer = m_threads.back().get();
+				owner.buffer->threadId = int(m_threads.size());
+			}
+		}
+		return *owner.buffer;
+	}
+
+}
@@ -0,0 +1,154 @@
+#pragma once
+
+#include "nether/GpuProfiler.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace nether
+{
+
+    // Completed CPU scope, times are steady_clock nanoseconds
+    struct CpuEvent
+    {
+        const char* name = nullptr;
+        long long beginNs = 0;
+        long long endNs = 0;
+        int threadId = 0;
+        int depth = 0;
+    };
+
+    // Scope profiler for CPU work on any thread. Each thread records completed scopes
+    // into its own fixed size ring, written only by that thread and drained by the
+    // thread calling EndFrame, so recording takes no locks; the mutex is only taken
+    // the first time a thread records. When a ring is full new events are dropped.
+    // Once a thread exits and its ring is drained, the ring and its thread id go to
+    // the next thread that starts recording, so threads coming and going (loader
+    // workers) don't add a ring each.
+    //
+    // Threads find their ring through a thread_local, so there is a single profiler,
+    // g_cpuProfiler.
+    //
+    // While capturing, drained events are kept and can be written together with
+    // GpuProfiler events as Chrome trace JSON (chrome://tracing, ui.perfetto.dev):
+    //
+    //  nether::g_cpuProfiler.SetCapture(true);
+    //  nether::g_gpuProfiler.SetCapture(true);
+    //  ... frames with NETHER_CPU_SCOPE / NETHER_GPU_SCOPE ...
+    //  nether::g_cpuProfiler.WriteChromeTrace("trace.json", nether::g_gpuProfiler);
+    //
+    // Scope names must outlive the profiler (string literals).
+    class CpuProfiler
+    {
+    public:
+        static constexpr int kThreadBufferSize = 16384;
+
+        CpuProfiler(const CpuProfiler&) = delete;
+        CpuProfiler& operator=(const CpuProfiler&) = delete;
+
+        // Same as g_cpuProfiler
+        static CpuProfiler& Instance();
+
+        static long long Now();
+
+        void Record(const char* name, long long beginNs, long long endNs, int depth);
+
+        // Drains every thread's ring, call once per frame from the main thread
+        void EndFrame();
+
+        void SetEnabled(bool enabled)
+        {
+            m_enabled.store(enabled, std::memory_order_relaxed);
+        }
+
+        bool IsEnabled() const
+        {
+            return m_enabled.load(std::memory_order_relaxed);
+        }
+
+        void SetCapture(bool capture)
+        {
+            m_capture = capture;
+        }
+
+        // Events drained by the most recent EndFrame
+        const std::vector<CpuEvent>& GetLastFrameEvents() const
+        {
+            return m_lastFrameEvents;
+        }
+
+        std::vector<CpuEvent> TakeCapturedEvents();
+
+        unsigned long long GetDroppedEvents() const;
+
+        // Writes the captured CPU events and gpuProfiler's captured events, moved onto
+        // the CPU clock, to one trace. Takes the captured events of both profilers.
+        bool WriteChromeTrace(const std::string& path, GpuProfiler& gpuProfiler);
+
+    private:
+        struct ThreadBuffer
+        {
+            CpuEvent events[kThreadBufferSize];
+            std::atomic<unsigned long long> head { 0 };
+            std::atomic<unsigned long long> tail { 0 };
+            std::atomic<unsigned long long> dropped { 0 };
+            // Set when the recording thread exits, the ring can be reused once drained
+            std::atomic<bool> exited { false };
+            int threadId = 0;
+        };
+
+        CpuProfiler() = default;
+
+        ThreadBuffer& GetThreadBuffer();
+
+        std::atomic<bool> m_enabled { true };
+        bool m_capture = false;
+
+        mutable std::mutex m_threadsMutex;
+        std::vector<std::unique_ptr<ThreadBuffer>> m_threads;
+
+        std::vector<CpuEvent> m_lastFrameEvents;
+        std::vector<CpuEvent> m_capturedEvents;
+    };
+
+    extern CpuProfiler& g_cpuProfiler;
+
+    class CpuScope
+    {
+    public:
+        explicit CpuScope(const char* name)
+        {
+            if (g_cpuProfiler.IsEnabled())
+            {
+                m_name = name;
+                m_depth = s_depth++;
+                m_begin = CpuProfiler::Now();
+            }
+        }
+
+        ~CpuScope()
+        {
+            if (m_name != nullptr)
+            {
+                s_depth--;
+                g_cpuProfiler.Record(m_name, m_begin, CpuProfiler::Now(), m_depth);
+            }
+        }
+
+        CpuScope(const CpuScope&) = delete;
+        CpuScope& operator=(const CpuScope&) = delete;
+
+    private:
+        static thread_local int s_depth;
+
+        const char* m_name = nullptr;
+        long long m_begin = 0;
+        int m_depth = 0;
+    };
+
+}
+
+#define NETHER_CPU_SCOPE(name) nether::CpuScope NETHER_GL_CONCAT(netherCpuScope_, __LINE__)(name)
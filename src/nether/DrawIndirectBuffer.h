@@ -0,0 +1,112 @@
+#pragma once
+
+#include "nether/StreamingBuffer.h"
+
+#include <cstring>
+#include <ranges>
+#include <span>
+#include <type_traits>
+
+namespace nether
+{
+
+    // Layouts glMultiDraw*Indirect reads from GL_DRAW_INDIRECT_BUFFER
+    struct DrawElementsIndirectCommand
+    {
+        unsigned int count = 0;
+        unsigned int instanceCount = 1;
+        unsigned int firstIndex = 0;
+        int baseVertex = 0;
+        unsigned int baseInstance = 0;
+    };
+
+    struct DrawArraysIndirectCommand
+    {
+        unsigned int count = 0;
+        unsigned int instanceCount = 1;
+        unsigned int first = 0;
+        unsigned int baseInstance = 0;
+    };
+
+    static_assert(sizeof(DrawElementsIndirectCommand) == 20, "DrawElementsIndirectCommand must match the GL layout");
+    static_assert(sizeof(DrawArraysIndirectCommand) == 16, "DrawArraysIndirectCommand must match the GL layout");
+
+    // Per frame draw commands for multi draw indirect, written straight into a
+    // persistently mapped StreamingBuffer on the indirect target. Each Write returns
+    // the byte offset of its commands, to pass to MultiDrawElements/MultiDrawArrays.
+    //
+    //  indirect.BeginFrame();
+    //  long long offset = indirect.Write(std::span(commands));
+    //  indirect.Bind();
+    //  indirect.MultiDrawElements(GL_TRIANGLES, GL_UNSIGNED_INT, offset, int(commands.size()));
+    //  indirect.EndFrame();
+    class DrawIndirectBuffer
+    {
+    public:
+        void Generate(long long maxBytesPerFrame)
+        {
+            m_buffer.Generate(BufferBindingTarget::DrawIndirectBuffer, maxBytesPerFrame);
+        }
+
+        void Delete()
+        {
+            m_buffer.Delete();
+        }
+
+        void BeginFrame()
+        {
+            m_buffer.BeginFrame();
+        }
+
+        void EndFrame()
+        {
+            m_buffer.EndFrame();
+        }
+
+        // Returns the byte offset of the first command, or -1 when the frame's region is full
+        template <typename Command>
+        long long Write(std::span<const std::type_identity_t<Command>> commands)
+        {
+            StreamingAllocation allocation = m_buffer.Allocate((long long)commands.size_bytes(), 4);
+            if (!allocation.IsValid())
+            {
+                return -1;
+            }
+            memcpy(allocation.data, commands.data(), commands.size_bytes());
+            return allocation.offset;
+        }
+
+        // Any contiguous range of commands: std::vector, std::array, C arrays, spans
+        template <typename Range>
+            requires std::ranges::contiguous_range<const Range&> && std::ranges::sized_range<const Range&>
+        long long Write(const Range& commands)
+        {
+            return Write<std::ranges::range_value_t<Range>>(commands);
+        }
+
+        void Bind()
+        {
+            m_buffer.Bind();
+        }
+
+        // The buffer must be bound
+        static void MultiDrawElements(unsigned int primitive, unsigned int indexType, long long byteOffset, int drawCount)
+        {
+            nether::gl::multiDrawElementsIndirect(primitive, indexType, reinterpret_cast<const void*>(byteOffset), drawCount, 0);
+        }
+
+        static void MultiDrawArrays(unsigned int primitive, long long byteOffset, int drawCount)
+        {
+            nether::gl::multiDrawArraysIndirect(primitive, reinterpret_cast<const void*>(byteOffset), drawCount, 0);
+        }
+
+        unsigned int GetBufferObject() const
+        {
+            return m_buffer.GetBufferObject();
+        }
+
+    private:
+        StreamingBuffer m_buffer;
+    };
+
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+namespace nether
+{
+
+    // Six planes with normals pointing inside, as xyz and distance in w, so a point p
+    // is inside a plane when dot(plane.xyz, p) + plane.w >= 0. Planes are normalized,
+    // which makes that value a signed distance usable against bounding sphere radii.
+    struct Frustum
+    {
+        enum Plane
+        {
+            Left,
+            Right,
+            Bottom,
+            Top,
+            Near,
+            Far,
+            PlaneCount
+        };
+
+        glm::vec4 planes[PlaneCount];
+
+        // Extracts the planes of a GL clip space (-w <= z <= w) view projection matrix
+        static Frustum FromMatrix(const glm::mat4& viewProjection)
+        {
+            // glm is column major, row i is (m[0][i], m[1][i], m[2][i], m[3][i])
+            const glm::vec4 row0(viewProjection[0][0], viewProjection[1][0], viewProjection[2][0], viewProjection[3][0]);
+            const glm::vec4 row1(viewProjection[0][1], viewProjection[1][1], viewProjection[2][1], viewProjection[3][1]);
+            const glm::vec4 row2(viewProjection[0][2], viewProjection[1][2], viewProjection[2][2], viewProjection[3][2]);
+            const glm::vec4 row3(viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3]);
+
+            Frustum frustum;
+            frustum.planes[Left] = row3 + row0;
+            frustum.planes[Right] = row3 - row0;
+            frustum.planes[Bottom] = row3 + row1;
+            frustum.planes[Top] = row3 - row1;
+            frustum.planes[Near] = row3 + row2;
+            frustum.planes[Far] = row3 - row2;
+
+            for (glm::vec4& plane : frustum.planes)
+            {
+                plane /= glm::length(glm::vec3(plane));
+            }
+            return frustum;
+        }
+
+        // Conservative: spheres near the frustum's corners may pass without being visible
+        bool IntersectsSphere(const glm::vec3& center, float radius) const
+        {
+            for (const glm::vec4& plane : planes)
+            {
+                if (glm::dot(glm::vec3(plane), center) + plane.w < -radius)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+    };
+
+}
@@ -0,0 +1,348 @@
+#include "FrustumCulling.h"
+
+#include <math.h>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define NETHER_CULL_X86
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+// MSVC compiles any intrinsic without flags
+#define NETHER_CULL_TARGET_SSE
+#define NETHER_CULL_TARGET_AVX2
+#else
+// Only these functions are built for the wider instruction sets, callers check the CPU first
+#define NETHER_CULL_TARGET_SSE __attribute__((target("sse2")))
+#define NETHER_CULL_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace nether {
+
+	namespace {
+
+		CullSimd DetectCullSimd()
+		{
+#if defined(NETHER_CULL_X86) && defined(_MSC_VER) && !defined(__clang__)
+			int info[4];
+			__cpuid(info, 0);
+			const int maxLeaf = info[0];
+
+			__cpuid(info, 1);
+			const bool sse2 = (info[3] & (1 << 26)) != 0;
+			const bool osxsave = (info[2] & (1 << 27)) != 0;
+			const bool avx = (info[2] & (1 << 28)) != 0;
+
+			// AVX registers are only usable if the OS saves them (XCR0 bits 1 and 2)
+			bool avx2 = false;
+			if (maxLeaf >= 7 && osxsave && avx && (_xgetbv(0) & 6) == 6)
+			{
+				__cpuidex(info, 7, 0);
+				avx2 = (info[1] & (1 << 5)) != 0;
+			}
+#elif defined(NETHER_CULL_X86)
+			__builtin_cpu_init();
+			const bool sse2 = __builtin_cpu_supports("sse2");
+			const bool avx2 = __builtin_cpu_supports("avx2");
+#else
+			const bool sse2 = false;
+			const bool avx2 = false;
+#endif
+			if (avx2)
+			{
+				return CullSimd::Avx2;
+			}
+			return sse2 ? CullSimd::Sse : CullSimd::Scalar;
+		}
+
+		CullSimd ResolveCullSimd(CullSimd requested)
+		{
+			const CullSimd supported = GetSupportedCullSimd();
+			if (requested == CullSimd::Auto || int(requested) > int(supported))
+			{
+				return supported;
+			}
+			return requested;
+		}
+
+		// Writes every lane's index but only advances past the visible ones, which is
+		// cheaper than branching on each object when visibility is hard to predict
+		inline size_t AppendVisible(unsigned int* visible, size_t count, size_t first, int mask, int lanes)
+		{
+			for (int lane = 0; lane < lanes; lane++)
+			{
+				visible[count] = (unsigned int)(first + lane);
+				count += (mask >> lane) & 1;
+			}
+			return count;
+		}
+
+		size_t CullSpheresScalar(const Frustum& frustum, const BoundingSpheres& spheres, size_t first, unsigned int* visible, size_t count)
+		{
+			// Same operation order as the SIMD loops so every path agrees on edge cases
+			for (size_t i = first; i < spheres.Size(); i++)
+			{
+				bool inside = true;
+				for (const glm::vec4& plane : frustum.planes)
+				{
+					const float distance = (plane.x * spheres.centerX[i] + plane.y * spheres.centerY[i]) + (plane.z * spheres.centerZ[i] + plane.w);
+					if (distance < -spheres.radius[i])
+					{
+						inside = false;
+						break;
+					}
+				}
+				if (inside)
+				{
+					visible[count++] = (unsigned int)i;
+				}
+			}
+			return count;
+		}
+
+		size_t CullBoxesScalar(const Frustum& frustum, const BoundingBoxes& boxes, size_t first, unsigned int* visible, size_t count)
+		{
+			for (size_t i = first; i < boxes.Size(); i++)
+			{
+				bool inside = true;
+				for (const glm::vec4& plane : frustum.planes)
+				{
+					const float distance = (plane.x * boxes.centerX[i] + plane.y * boxes.centerY[i]) + (plane.z * boxes.centerZ[i] + plane.w);
+					const float radius = (fabsf(plane.x) * boxes.extentX[i] + fabsf(plane.y) * boxes.extentY[i]) + fabsf(plane.z) * boxes.extentZ[i];
+					if (distance + radius < 0.f)
+					{
+						inside = false;
+						break;
+					}
+				}
+				if (inside)
+				{
+					visible[count++] = (unsigned int)i;
+				}
+			}
+			return count;
+		}
+
+#ifdef NETHER_CULL_X86
+		// The SIMD loops handle whole groups of lanes and leave the rest to the scalar
+		// loop; first is set to where they stopped
+
+		NETHER_CULL_TARGET_SSE size_t CullSpheresSse(const Frustum& frustum, const BoundingSpheres& spheres, unsigned int* visible, size_t& first)
+		{
+			__m128 planeX[Frustum::PlaneCount], planeY[Frustum::PlaneCount], planeZ[Frustum::PlaneCount], planeW[Frustum::PlaneCount];
+			for (int plane = 0; plane < Frustum::PlaneCount; plane++)
+			{
+				planeX[plane] = _mm_set1_ps(frustum.planes[plane].x);
+				planeY[plane] = _mm_set1_ps(frustum.planes[plane].y);
+				planeZ[plane] = _mm_set1_ps(frustum.planes[plane].z);
+				planeW[plane] = _mm_set1_ps(frustum.planes[plane].w);
+			}
+
+			const size_t end = spheres.Size() & ~size_t(3);
+			size_t count = 0;
+			for (size_t i = 0; i < end; i += 4)
+			{
+				const __m128 x = _mm_loadu_ps(&spheres.centerX[i]);
+				const __m128 y = _mm_loadu_ps(&spheres.centerY[i]);
+				const __m128 z = _mm_loadu_ps(&spheres.centerZ[i]);
+				const __m128 negativeRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(&spheres.radius[i]));
+
+				__m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+				for (int plane = 0; plane < Frustum::PlaneCount; plane++)
+				{
+					const __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(planeX[plane], x), _mm_mul_ps(planeY[plane], y)),
+						_mm_add_ps(_mm_mul_ps(planeZ[plane], z), planeW[plane]));
+					inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, negativeRadius));
+				}
+				count = AppendVisible(visible, count, i, _mm_movemask_ps(inside), 4);
+			}
+			first = end;
+			return count;
+		}
+
+		NETHER_CULL_TARGET_SSE size_t CullBoxesSse(const Frustum& frustum, const BoundingBoxes& boxes, unsigned int* visible, size_t& first)
+		{
+			__m128 planeX[Frustum::PlaneCount], planeY[Frustum::PlaneCount], planeZ[Frustum::PlaneCount], planeW[Frustum::PlaneCount];
+			__m128 absX[Frustum::PlaneCount], absY[Frustum::PlaneCount], absZ[Frustum::PlaneCount];
+			for (int plane = 0; plane < Frustum::PlaneCount; plane++)
+			{
+				planeX[plane] = _mm_set1_ps(frustum.planes[plane].x);
+				planeY[plane] = _mm_set1_ps(frustum.planes[plane].y);
+				planeZ[plane] = _mm_set1_ps(frustum.planes[plane].z);
+				planeW[plane] = _mm_set1_ps(frustum.planes[plane].w);
+				absX[plane] = _mm_set1_ps(fabsf(frustum.planes[plane].x));
+				absY[plane] = _mm_set1_ps(fabsf(frustum.planes[plane].y));
+				absZ[plane] = _mm_set1_ps(fabsf(frustum.planes[plane].z));
+			}
+
+			const size_t end = boxes.Size() & ~size_t(3);
+			size_t count = 0;
+			for (size_t i = 0; i < end; i += 4)
+			{
+				const __m128 x = _mm_loadu_ps(&boxes.centerX[i]);
+				const __m128 y = _mm_loadu_ps(&boxes.centerY[i]);
+				const __m128 z = _mm_loadu_ps(&boxes.centerZ[i]);
+				const __m128 extentX = _mm_loadu_ps(&boxes.extentX[i]);
+				const __m128 extentY = _mm_loadu_ps(&boxes.extentY[i]);
+				const __m128 extentZ = _mm_loadu_ps(&boxes.extentZ[i]);
+
+				__m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+				for (int plane = 0; plane < Frustum::PlaneCount; plane++)
+				{
+					const __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(planeX[plane], x), _mm_mul_ps(planeY[plane], y)),
+						_mm_add_ps(_mm_mul_ps(planeZ[plane], z), planeW[plane]));
+					// Projected half size of the box on the plane normal
+					const __m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(absX[plane], extentX), _mm_mul_ps(absY[plane], extentY)),
+						_mm_mul_ps(absZ[plane], extentZ));
+					inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(distance, radius), _mm_setzero_ps()));
+				}
+				count = AppendVisible(visible, count, i, _mm_movemask_ps(inside), 4);
+			}
+			first = end;
+			return count;
+		}
+
+		NETHER_CULL_TARGET_AVX2 size_t CullSpheresAvx2(const Frustum& frustum, const BoundingSpheres& spheres, unsigned int* visible, size_t& first)
+		{
+			__m256 planeX[Frustum::PlaneCount], planeY[Frustum::PlaneCount], planeZ[Frustum::PlaneCount], planeW[Frustum::PlaneCount];
+			for (int plane = 0; plane < Frustum::PlaneCount; plane++)
+			{
+				planeX[plane] = _mm256_set1_ps(frustum.planes[plane].x);
+				planeY[plane] = _mm256_set1_ps(frustum.planes[plane].y);
+				planeZ[plane] = _mm256_set1_ps(frustum.planes[plane].z);
+				planeW[plane] = _mm256_set1_ps(frustum.planes[plane].w);
+			}
+
+			const size_t end = spheres.Size() & ~size_t(7);
+			size_t count = 0;
+			for (size_t i = 0; i < end; i += 8)
+			{
+				const __m256 x = _mm256_loadu_ps(&spheres.centerX[i]);
+				const __m256 y = _mm256_loadu_ps(&spheres.centerY[i]);
+				const __m256 z = _mm256_loadu_ps(&spheres.centerZ[i]);
+				const __m256 negativeRadius = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(&spheres.radius[i]));
+
+				__m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+				for (int plane = 0; plane < Frustum::PlaneCount; plane++)
+				{
+					const __m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(planeX[plane], x), _mm256_mul_ps(planeY[plane], y)),
+						_mm256_add_ps(_mm256_mul_ps(planeZ[plane], z), planeW[plane]));
+					inside = _mm256_and_ps(inside, _mm256_cmp_ps(distance, negativeRadius, _CMP_GE_OQ));
+				}
+				count = AppendVisible(visible, count, i, _mm256_movemask_ps(inside), 8);
+			}
+			first = end;
+			return count;
+		}
+
+		NETHER_CULL_TARGET_AVX2 size_t CullBoxesAvx2(const Frustum& frustum, const BoundingBoxes& boxes, unsigned int* visible, size_t& first)
+		{
+			__m256 planeX[Frustum::PlaneCount], planeY[Frustum::PlaneCount], planeZ[Frustum::PlaneCount], planeW[Frustum::PlaneCount];
+			__m256 absX[Frustum::PlaneCount], absY[Frustum::PlaneCount], absZ[Frustum::PlaneCount];
+			for (int plane = 0; plane < Frustum::PlaneCount; plane++)
+			{
+				planeX[plane] = _mm256_set1_ps(frustum.planes[plane].x);
+				planeY[plane] = _mm256_set1_ps(frustum.planes[plane].y);
+				planeZ[plane] = _mm256_set1_ps(frustum.planes[plane].z);
+				planeW[plane] = _mm256_set1_ps(frustum.planes[plane].w);
+				absX[plane] = _mm256_set1_ps(fabsf(frustum.planes[plane].x));
+				absY[plane] = _mm256_set1_ps(fabsf(frustum.planes[plane].y));
+				absZ[plane] = _mm256_set1_ps(fabsf(frustum.planes[plane].z));
+			}
+
+			const size_t end = boxes.Size() & ~size_t(7);
+			size_t count = 0;
+			for (size_t i = 0; i < end; i += 8)
+			{
+				const __m256 x = _mm256_loadu_ps(&boxes.centerX[i]);
+				const __m256 y = _mm256_loadu_ps(&boxes.centerY[i]);
+				const __m256 z = _mm256_loadu_ps(&boxes.centerZ[i]);
+				const __m256 extentX = _mm256_loadu_ps(&boxes.extentX[i]);
+				const __m256 extentY = _mm256_loadu_ps(&boxes.extentY[i]);
+				const __m256 extentZ = _mm256_loadu_ps(&boxes.extentZ[i]);
+
+				__m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+				for (int plane = 0; plane < Frustum::PlaneCount; plane++)
+				{
+					const __m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(planeX[plane], x), _mm256_mul_ps(planeY[plane], y)),
+						_mm256_add_ps(_mm256_mul_ps(planeZ[plane], z), planeW[plane]));
+					const __m256 radius = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(absX[plane], extentX), _mm256_mul_ps(absY[plane], extentY)),
+						_mm256_mul_ps(absZ[plane], extentZ));
+					inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_add_ps(distance, radius), _mm256_setzero_ps(), _CMP_GE_OQ));
+				}
+				count = AppendVisible(visible, count, i, _mm256_movemask_ps(inside), 8);
+			}
+			first = end;
+			return count;
+		}
+#endif
+
+	}
+
+	CullSimd GetSupportedCullSimd()
+	{
+		static const CullSimd supported = DetectCullSimd();
+		return supported;
+	}
+
+	const char* GetCullSimdName(CullSimd simd)
+	{
+		switch (simd)
+		{
+		case CullSimd::Auto:
+			return "auto";
+		case CullSimd::Scalar:
+			return "scalar";
+		case CullSimd::Sse:
+			return "sse";
+		case CullSimd::Avx2:
+			return "avx2";
+		}
+		return "unknown";
+	}
+
+	size_t CullSpheres(const Frustum& frustum, const BoundingSpheres& spheres, unsigned int* visible, CullSimd simd)
+	{
+		size_t first = 0;
+		size_t count = 0;
+#ifdef NETHER_CULL_X86
+		switch (ResolveCullSimd(simd))
+		{
+		case CullSimd::Avx2:
+			count = CullSpheresAvx2(frustum, spheres, visible, first);
+			break;
+		case CullSimd::Sse:
+			count = CullSpheresSse(frustum, spheres, visible, first);
+			break;
+		default:
+			break;
+		}
+#else
+		(void)simd;
+#endif
+		return CullSpheresScalar(frustum, spheres, first, visible, count);
+	}
+
+	size_t CullBoxes(const Frustum& frustum, const BoundingBoxes& boxes, unsigned int* visible, CullSimd simd)
+	{
+		size_t first = 0;
+		size_t count = 0;
+#ifdef NETHER_CULL_X86
+		switch (ResolveCullSimd(simd))
+		{
+		case CullSimd::Avx2:
+			count = CullBoxesAvx2(frustum, boxes, visible, first);
+			break;
+		case CullSimd::Sse:
+			count = CullBoxesSse(frustum, boxes, visible, first);
+			break;
+		default:
+			break;
+		}
+#else
+		(void)simd;
+#endif
+		return CullBoxesScalar(frustum, boxes, first, visible, count);
+	}
+
+}
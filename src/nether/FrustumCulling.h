@@ -0,0 +1,126 @@
+#pragma once
+
+#include "nether/Frustum.h"
+
+#include <glm/glm.hpp>
+
+#include <stddef.h>
+#include <vector>
+
+namespace nether
+{
+
+    // Bounding spheres as a structure of arrays, so the culling loops load 4 or 8
+    // objects' coordinates with one instruction
+    struct BoundingSpheres
+    {
+        std::vector<float> centerX;
+        std::vector<float> centerY;
+        std::vector<float> centerZ;
+        std::vector<float> radius;
+
+        void Reserve(size_t count)
+        {
+            centerX.reserve(count);
+            centerY.reserve(count);
+            centerZ.reserve(count);
+            radius.reserve(count);
+        }
+
+        void Add(const glm::vec3& center, float sphereRadius)
+        {
+            centerX.push_back(center.x);
+            centerY.push_back(center.y);
+            centerZ.push_back(center.z);
+            radius.push_back(sphereRadius);
+        }
+
+        void Clear()
+        {
+            centerX.clear();
+            centerY.clear();
+            centerZ.clear();
+            radius.clear();
+        }
+
+        size_t Size() const
+        {
+            return radius.size();
+        }
+    };
+
+    // Axis aligned boxes as a structure of arrays, stored as center and half extent,
+    // the form the plane test needs
+    struct BoundingBoxes
+    {
+        std::vector<float> centerX;
+        std::vector<float> centerY;
+        std::vector<float> centerZ;
+        std::vector<float> extentX;
+        std::vector<float> extentY;
+        std::vector<float> extentZ;
+
+        void Reserve(size_t count)
+        {
+            centerX.reserve(count);
+            centerY.reserve(count);
+            centerZ.reserve(count);
+            extentX.reserve(count);
+            extentY.reserve(count);
+            extentZ.reserve(count);
+        }
+
+        void Add(const glm::vec3& min, const glm::vec3& max)
+        {
+            centerX.push_back((min.x + max.x) * 0.5f);
+            centerY.push_back((min.y + max.y) * 0.5f);
+            centerZ.push_back((min.z + max.z) * 0.5f);
+            extentX.push_back((max.x - min.x) * 0.5f);
+            extentY.push_back((max.y - min.y) * 0.5f);
+            extentZ.push_back((max.z - min.z) * 0.5f);
+        }
+
+        void Clear()
+        {
+            centerX.clear();
+            centerY.clear();
+            centerZ.clear();
+            extentX.clear();
+            extentY.clear();
+            extentZ.clear();
+        }
+
+        size_t Size() const
+        {
+            return centerX.size();
+        }
+    };
+
+    // Instruction set used by the culling loops. Auto picks the widest one the CPU
+    // supports; asking for one it lacks falls back to the widest it has below it.
+    enum class CullSimd
+    {
+        Auto,
+        Scalar,
+        Sse,    // 4 objects per instruction
+        Avx2    // 8 objects per instruction
+    };
+
+    // Widest instruction set usable on this CPU, detected once at runtime so the same
+    // binary runs on machines without AVX2
+    CullSimd GetSupportedCullSimd();
+
+    const char* GetCullSimdName(CullSimd simd);
+
+    // CPU frustum culling, the fallback for when GpuCuller cannot be used. Writes the
+    // indices of the objects intersecting the frustum to visible, in ascending order,
+    // and returns how many there are. visible must have room for every object.
+    // The tests are conservative, like Frustum::IntersectsSphere.
+    //
+    //  const Frustum frustum = camera.GetFrustum();
+    //  visible.resize(spheres.Size());
+    //  visible.resize(CullSpheres(frustum, spheres, visible.data()));
+    size_t CullSpheres(const Frustum& frustum, const BoundingSpheres& spheres, unsigned int* visible, CullSimd simd = CullSimd::Auto);
+    size_t CullBoxes(const Frustum& frustum, const BoundingBoxes& boxes, unsigned int* visible, CullSimd simd = CullSimd::Auto);
+
+}
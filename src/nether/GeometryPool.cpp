@@ -0,0 +1,60 @@
+#include "GeometryPool.h"
+
+namespace nether {
+
+	void GeometryPool::Generate(int vertexStride)
+	{
+		m_vertexStride = vertexStride;
+		m_vertexCount = 0;
+		m_indexCount = 0;
+
+		m_vao.Generate();
+		m_vertices.Generate(BufferBindingTarget::ArrayBuffer);
+		m_indices.Generate(BufferBindingTarget::ElementArrayBuffer);
+
+		// The element buffer binding is VAO state, so it is attached once here
+		m_vao.Bind();
+		m_indices.Bind();
+		m_vao.Unbind();
+	}
+
+	void GeometryPool::Delete()
+	{
+		m_vao.Delete();
+		m_vertices.Delete();
+		m_indices.Delete();
+		m_vertexCount = 0;
+		m_indexCount = 0;
+	}
+
+	void GeometryPool::AddVertexAttribute(unsigned int location, int size, GLType type, int offset)
+	{
+		m_vao.Bind();
+		m_vertices.Bind();
+		m_vao.AddVertexAttribPointer(location, size, type, GLBoolean::False, m_vertexStride, reinterpret_cast<GLvoid*>((size_t)offset));
+		m_vao.EnableVertexAttribArray(location);
+		m_vao.Unbind();
+	}
+
+	PooledMesh GeometryPool::AddMeshBytes(const void* vertices, long long vertexBytes, std::span<const unsigned int> indices)
+	{
+		PooledMesh mesh;
+		mesh.firstIndex = m_indexCount;
+		mesh.indexCount = int(indices.size());
+		mesh.baseVertex = m_vertexCount;
+
+		const std::span<const unsigned char> vertexData(static_cast<const unsigned char*>(vertices), (size_t)vertexBytes);
+
+		// Growing keeps the buffer names, so the VAO stays valid
+		m_vao.Bind();
+		m_vertices.Bind();
+		m_vertices.UpdateRange((long long)m_vertexCount * m_vertexStride, vertexData);
+		m_indices.UpdateRange((long long)m_indexCount * sizeof(unsigned int), indices);
+		m_vao.Unbind();
+
+		m_vertexCount += int(vertexBytes / m_vertexStride);
+		m_indexCount += (unsigned int)indices.size();
+		return mesh;
+	}
+
+}
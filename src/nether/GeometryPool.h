@@ -0,0 +1,90 @@
+#pragma once
+
+#include "nether/BufferObject.h"
+#include "nether/GLType.h"
+#include "nether/VertexArrayObject.h"
+
+#include <ranges>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace nether
+{
+
+    // Where a mesh ended up in a GeometryPool, in the units DrawElementsIndirectCommand
+    // and drawElementsBaseVertex expect
+    struct PooledMesh
+    {
+        unsigned int firstIndex = 0;
+        int indexCount = 0;
+        int baseVertex = 0;
+
+        long long GetIndexByteOffset() const
+        {
+            return (long long)firstIndex * sizeof(unsigned int);
+        }
+    };
+
+    // Vertex and index buffers shared by every mesh with the same vertex layout, so
+    // meshes can be drawn without changing the VAO and merged into multi draw calls.
+    // Indices are 32 bit and local to their mesh; base vertex moves them to where
+    // the mesh's vertices were appended.
+    //
+    //  pool.Generate(5 * sizeof(float));
+    //  pool.AddVertexAttribute(0, 3, GLType::Float, 0);
+    //  pool.AddVertexAttribute(1, 2, GLType::Float, 3 * sizeof(float));
+    //  PooledMesh cube = pool.AddMesh(std::span(cubeVertices), std::span(cubeIndices));
+    //  commands.DrawElements(program, pool.GetVAO(), GL_TRIANGLES, cube.indexCount,
+    //      GL_UNSIGNED_INT, cube.GetIndexByteOffset(), cube.baseVertex);
+    class GeometryPool
+    {
+    public:
+        void Generate(int vertexStride);
+        void Delete();
+
+        // Floating point attribute read from offset bytes into each vertex
+        void AddVertexAttribute(unsigned int location, int size, GLType type, int offset);
+
+        // vertices must be a whole number of vertexStride sized vertices
+        template <typename T>
+        PooledMesh AddMesh(std::span<const std::type_identity_t<T>> vertices, std::span<const unsigned int> indices)
+        {
+            return AddMeshBytes(vertices.data(), (long long)vertices.size_bytes(), indices);
+        }
+
+        // Any contiguous ranges: std::vector, std::array, C arrays, spans
+        template <typename VertexRange, typename IndexRange>
+            requires std::ranges::contiguous_range<const VertexRange&> && std::ranges::sized_range<const VertexRange&>
+        PooledMesh AddMesh(const VertexRange& vertices, const IndexRange& indices)
+        {
+            return AddMesh<std::ranges::range_value_t<VertexRange>>(vertices, std::span<const unsigned int>(indices));
+        }
+
+        unsigned int GetVAO() const
+        {
+            return m_vao.GetVAO();
+        }
+
+        int GetVertexCount() const
+        {
+            return m_vertexCount;
+        }
+
+        unsigned int GetIndexCount() const
+        {
+            return m_indexCount;
+        }
+
+    private:
+        PooledMesh AddMeshBytes(const void* vertices, long long vertexBytes, std::span<const unsigned int> indices);
+
+        VertexArrayObject m_vao;
+        BufferObject m_vertices;
+        BufferObject m_indices;
+        int m_vertexStride = 0;
+        int m_vertexCount = 0;
+        unsigned int m_indexCount = 0;
+    };
+
+}
@@ -0,0 +1,258 @@
+#include "GpuCuller.h"
+
+#include <algorithm>
+#include <stdio.h>
+
+namespace nether {
+
+	namespace {
+
+		// Matches GpuCullInstance and DrawElementsIndirectCommand (std430 packs the
+		// command struct at 20 bytes, like the C++ side)
+		const char* kCullShader = R"(
+			#version 430 core
+			layout (local_size_x = 64) in;
+
+			struct Instance
+			{
+				mat4 model;
+				vec4 sphere;
+				uint mesh;
+				uint padding0;
+				uint padding1;
+				uint padding2;
+			};
+
+			struct Command
+			{
+				uint count;
+				uint instanceCount;
+				uint firstIndex;
+				int baseVertex;
+				uint baseInstance;
+			};
+
+			layout (std430, binding = 3) readonly buffer Instances
+			{
+				Instance instances[];
+			};
+
+			layout (std430, binding = 4) writeonly buffer Visible
+			{
+				mat4 visibleModel[];
+			};
+
+			layout (std430, binding = 5) buffer Commands
+			{
+				Command commands[];
+			};
+
+			uniform int instanceCount;
+			// Set when the instances take more than one dispatch
+			uniform int firstInstance;
+			uniform vec4 planes[6];
+
+			void main()
+			{
+				uint index = uint(firstInstance) + gl_GlobalInvocationID.x;
+				if (index >= uint(instanceCount))
+				{
+					return;
+				}
+
+				mat4 model = instances[index].model;
+				vec4 sphere = instances[index].sphere;
+				vec3 center = (model * vec4(sphere.xyz, 1.0)).xyz;
+				float scale = sqrt(max(max(dot(model[0].xyz, model[0].xyz), dot(model[1].xyz, model[1].xyz)), dot(model[2].xyz, model[2].xyz)));
+				float radius = sphere.w * scale;
+
+				for (int plane = 0; plane < 6; plane++)
+				{
+					if (dot(planes[plane].xyz, center) + planes[plane].w < -radius)
+					{
+						return;
+					}
+				}
+
+				uint mesh = instances[index].mesh;
+				uint slot = atomicAdd(commands[mesh].instanceCount, 1u);
+				visibleModel[commands[mesh].baseInstance + slot] = model;
+			}
+		)";
+
+	}
+
+	bool GpuCuller::Init()
+	{
+		m_program.LoadFromRawString(kCullShader);
+		ShaderProgram& program = m_program.GetShaderProgram();
+		if (!m_program.IsValid())
+		{
+			printf("GpuCuller: %s\n%s\n", program.GetComputeShaderCompilationInfo().infoText.c_str(),
+				program.GetShaderProgramCompilationInfo().infoText.c_str());
+			return false;
+		}
+
+		m_instanceCountUniform = program.GetUniformHandle("instanceCount");
+		m_firstInstanceUniform = program.GetUniformHandle("firstInstance");
+		for (int plane = 0; plane < Frustum::PlaneCount; plane++)
+		{
+			m_planeUniforms[plane] = program.GetUniformHandle("planes[" + std::to_string(plane) + "]");
+		}
+
+		m_instances.Generate(kInstanceBinding);
+		m_visible.Generate(kVisibleBinding, BufferUsage::DynamicCopy);
+		m_commands.Generate(BufferBindingTarget::DrawIndirectBuffer, BufferUsage::DynamicCopy);
+		m_commandTemplate.Generate(BufferBindingTarget::DrawIndirectBuffer);
+		return true;
+	}
+
+	void GpuCuller::Shutdown()
+	{
+		m_program.Delete();
+		m_instances.Delete();
+		m_visible.Delete();
+		m_commands.Delete();
+		m_commandTemplate.Delete();
+		m_instanceMeshes.clear();
+		m_instanceCount = 0;
+		m_meshCount = 0;
+	}
+
+	bool GpuCuller::SetScene(std::span<const DrawElementsIndirectCommand> meshes, std::span<const GpuCullInstance> instances)
+	{
+		// The shader counts instances into commands[mesh] without checking the index
+		for (size_t i = 0; i < instances.size(); i++)
+		{
+			if (instances[i].mesh >= meshes.size())
+			{
+				printf("GpuCuller: instance %zu refers to mesh %u, there are %zu meshes\n", i, instances[i].mesh, meshes.size());
+				m_instanceMeshes.clear();
+				m_instanceCount = 0;
+				m_meshCount = 0;
+				return false;
+			}
+		}
+
+		m_instanceCount = int(instances.size());
+		m_meshCount = int(meshes.size());
+
+		// Each mesh reserves room for all its instances in the visible buffer
+		std::vector<unsigned int> instancesPerMesh(meshes.size(), 0);
+		m_instanceMeshes.resize(instances.size());
+		for (size_t i = 0; i < instances.size(); i++)
+		{
+			m_instanceMeshes[i] = instances[i].mesh;
+			instancesPerMesh[instances[i].mesh]++;
+		}
+
+		m_meshCommands.assign(meshes.begin(), meshes.end());
+		unsigned int baseInstance = 0;
+		for (size_t mesh = 0; mesh < meshes.size(); mesh++)
+		{
+			m_meshCommands[mesh].instanceCount = 0;
+			m_meshCommands[mesh].baseInstance = baseInstance;
+			baseInstance += instancesPerMesh[mesh];
+		}
+
+		m_instances.Upload(instances);
+		m_visible.Resize(instances.size());
+
+		m_commandTemplate.Bind();
+		m_commandTemplate.UploadBufferData(m_meshCommands);
+		m_commands.Bind();
+		m_commands.UploadBufferData(m_meshCommands);
+		return true;
+	}
+
+	bool GpuCuller::UpdateInstances(int first, std::span<const GpuCullInstance> instances)
+	{
+		if (first < 0 || (size_t)first + instances.size() > (size_t)m_instanceCount)
+		{
+			printf("GpuCuller: can't update %zu instances from %d, there are %d instances\n", instances.size(), first, m_instanceCount);
+			return false;
+		}
+
+		// Moving an instance to another mesh would overflow that mesh's visible range
+		for (size_t i = 0; i < instances.size(); i++)
+		{
+			const size_t instance = (size_t)first + i;
+			if (instances[i].mesh >= m_meshCommands.size())
+			{
+				printf("GpuCuller: instance %zu refers to mesh %u, there are %zu meshes\n", instance, instances[i].mesh, m_meshCommands.size());
+				return false;
+			}
+			if (instances[i].mesh != m_instanceMeshes[instance])
+			{
+				printf("GpuCuller: instance %zu can't move from mesh %u to mesh %u, call SetScene\n", instance, m_instanceMeshes[instance], instances[i].mesh);
+				return false;
+			}
+		}
+
+		m_instances.Update((size_t)first, instances);
+		return true;
+	}
+
+	void GpuCuller::Cull(const Frustum& frustum)
+	{
+		if (m_instanceCount == 0)
+		{
+			return;
+		}
+
+		nether::gl::bindBuffer(GL_COPY_READ_BUFFER, m_commandTemplate.GetBufferObject());
+		nether::gl::bindBuffer(GL_COPY_WRITE_BUFFER, m_commands.GetBufferObject());
+		nether::gl::copyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0,
+			(long long)m_meshCount * sizeof(DrawElementsIndirectCommand));
+
+		ShaderProgram& program = m_program.GetShaderProgram();
+		m_program.Use();
+		program.SetIntUniform(m_instanceCountUniform, m_instanceCount);
+		for (int plane = 0; plane < Frustum::PlaneCount; plane++)
+		{
+			program.SetVec4Uniform(m_planeUniforms[plane], frustum.planes[plane]);
+		}
+
+		m_instances.Bind();
+		m_visible.Bind();
+		nether::gl::bindBufferBase(GL_SHADER_STORAGE_BUFFER, kCommandBinding, m_commands.GetBufferObject());
+
+		// One dispatch covers at most GL_MAX_COMPUTE_WORK_GROUP_COUNT groups
+		const long long perDispatch = (long long)m_program.GetMaxWorkGroupCount(0) * m_program.GetWorkGroupSize().x;
+		for (long long first = 0; first < m_instanceCount; first += perDispatch)
+		{
+			program.SetIntUniform(m_firstInstanceUniform, int(first));
+			m_program.DispatchInvocations((unsigned int)std::min(perDispatch, m_instanceCount - first));
+		}
+		ComputeProgram::Barrier(GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+	}
+
+	void GpuCuller::Draw(unsigned int primitive, unsigned int indexType)
+	{
+		if (m_instanceCount == 0)
+		{
+			return;
+		}
+
+		m_visible.Bind();
+		m_commands.Bind();
+		DrawIndirectBuffer::MultiDrawElements(primitive, indexType, 0, m_meshCount);
+	}
+
+	int GpuCuller::ReadVisibleCount()
+	{
+		ComputeProgram::Barrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+
+		std::vector<DrawElementsIndirectCommand> commands(m_meshCount);
+		m_commands.Bind();
+		nether::gl::getBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, (long long)commands.size() * sizeof(DrawElementsIndirectCommand), commands.data());
+
+		int visible = 0;
+		for (const DrawElementsIndirectCommand& command : commands)
+		{
+			visible += int(command.instanceCount);
+		}
+		return visible;
+	}
+
+}
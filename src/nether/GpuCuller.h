@@ -0,0 +1,126 @@
+#pragma once
+
+#include "nether/BufferObject.h"
+#include "nether/ComputeProgram.h"
+#include "nether/DrawIndirectBuffer.h"
+#include "nether/Frustum.h"
+#include "nether/StorageBuffer.h"
+
+#include <glm/glm.hpp>
+
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace nether
+{
+
+    // One object for GpuCuller, laid out as the std430 struct the culling shader reads.
+    // sphere is the mesh's bounding sphere in model space (center xyz, radius w), it is
+    // moved to world space with model, radius scaled by the largest axis scale.
+    struct GpuCullInstance
+    {
+        glm::mat4 model = glm::mat4(1.f);
+        glm::vec4 sphere = glm::vec4(0.f, 0.f, 0.f, 1.f);
+        // Index of the mesh, in the commands given to GpuCuller::SetScene
+        unsigned int mesh = 0;
+        unsigned int padding[3] = {};
+    };
+
+    static_assert(sizeof(GpuCullInstance) == 96, "GpuCullInstance must match the std430 layout");
+    static_assert(std::is_trivially_copyable_v<GpuCullInstance>, "GpuCullInstance must stay POD");
+
+    // Frustum culling on the GPU. A compute pass tests every instance's bounding sphere
+    // and appends the model matrix of the visible ones to the visible buffer, in the
+    // range its mesh's indirect command reserves, while atomically counting them into
+    // that command's instanceCount. The compacted commands are then drawn with one
+    // multi draw indirect call without the CPU ever reading the results, so the cost
+    // on the CPU does not depend on the number of instances.
+    //
+    // The vertex shader reads the visible transforms from kVisibleBinding:
+    //
+    //  #extension GL_ARB_shader_draw_parameters : require
+    //  layout (std430, binding = 4) readonly buffer Visible { mat4 visibleModel[]; };
+    //  ... visibleModel[gl_BaseInstanceARB + gl_InstanceID] ...
+    //
+    //  culler.SetScene(meshCommands, instances);
+    //  culler.Cull(Frustum::FromMatrix(cameraBlock.viewProjection));
+    //  program.Use(); vao.Bind();
+    //  culler.Draw(GL_TRIANGLES, GL_UNSIGNED_INT);
+    //
+    // Requires GL 4.3.
+    class GpuCuller
+    {
+    public:
+        static constexpr unsigned int kInstanceBinding = 3;
+        static constexpr unsigned int kVisibleBinding = 4;
+        static constexpr unsigned int kCommandBinding = 5;
+
+        // Compiles the culling shader, returns false if it failed
+        bool Init();
+        void Shutdown();
+
+        // meshes holds one command per mesh, only count, firstIndex and baseVertex are
+        // used; instances refer to them by index. Uploads everything, call again only
+        // when the scene changes. Instances can also be moved with UpdateInstances.
+        // Prints why and returns false, leaving the scene empty, if an instance refers
+        // to a mesh that doesn't exist.
+        bool SetScene(std::span<const DrawElementsIndirectCommand> meshes, std::span<const GpuCullInstance> instances);
+
+        // Overwrites instances starting at first, their mesh must not change. Prints why
+        // and returns false, uploading nothing, if the range goes past the scene's
+        // instances or an instance's mesh differs from the one it was given.
+        bool UpdateInstances(int first, std::span<const GpuCullInstance> instances);
+
+        // Resets the commands' instance counts and runs the culling pass. Results are
+        // made visible to indirect draws and shader storage reads.
+        void Cull(const Frustum& frustum);
+
+        // Binds the visible buffer and draws the culled commands, the program and the
+        // VAO with the meshes must be bound
+        void Draw(unsigned int primitive, unsigned int indexType);
+
+        // Number of visible instances, reads the commands back so it stalls until the
+        // pass is done; for tests and statistics only
+        int ReadVisibleCount();
+
+        int GetInstanceCount() const
+        {
+            return m_instanceCount;
+        }
+
+        int GetMeshCount() const
+        {
+            return m_meshCount;
+        }
+
+        unsigned int GetCommandBuffer() const
+        {
+            return m_commands.GetBufferObject();
+        }
+
+        unsigned int GetVisibleBuffer() const
+        {
+            return m_visible.GetBufferObject();
+        }
+
+    private:
+        ComputeProgram m_program;
+        UniformHandle m_instanceCountUniform;
+        UniformHandle m_firstInstanceUniform;
+        UniformHandle m_planeUniforms[Frustum::PlaneCount];
+
+        StorageBuffer<GpuCullInstance> m_instances;
+        StorageBuffer<glm::mat4> m_visible;
+        BufferObject m_commands;
+        // Commands with instanceCount 0, copied over m_commands before each pass
+        BufferObject m_commandTemplate;
+
+        std::vector<DrawElementsIndirectCommand> m_meshCommands;
+        // Mesh of each instance, the visible ranges were reserved from these
+        std::vector<unsigned int> m_instanceMeshes;
+        int m_instanceCount = 0;
+        int m_meshCount = 0;
+    };
+
+}
@@ -0,0 +1,277 @@
+#include "GpuProfiler.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace nether {
+
+	GpuProfiler g_gpuProfiler;
+
+	namespace {
+
+		constexpr int kQueryBatch = 64;
+
+	}
+
+	void GpuProfiler::Init()
+	{
+		int major = 0, minor = 0;
+		nether::gl::getIntegerv(GL_MAJOR_VERSION, &major);
+		nether::gl::getIntegerv(GL_MINOR_VERSION, &minor);
+		m_debugGroupsSupported = major > 4 || (major == 4 && minor >= 3);
+		m_debugGroups = m_debugGroupsSupported;
+
+		m_frame = 0;
+		m_droppedFrames = 0;
+		m_initialized = true;
+		SyncClocks();
+	}
+
+	void GpuProfiler::Shutdown()
+	{
+		if (!m_allQueries.empty())
+		{
+			nether::gl::deleteQueries(int(m_allQueries.size()), m_allQueries.data());
+		}
+		m_allQueries.clear();
+		m_freeQueries.clear();
+		for (FrameQueries& frame : m_frames)
+		{
+			frame.scopes.clear();
+			frame.lastQuery = 0;
+		}
+		m_openScopes.clear();
+		m_initialized = false;
+		m_inFrame = false;
+	}
+
+	void GpuProfiler::BeginFrame()
+	{
+		if (!m_initialized || !m_enabled)
+		{
+			return;
+		}
+
+		// The slot about to be reused holds the frame from kFrameLatency frames ago
+		FrameQueries& frame = m_frames[m_frame % kFrameLatency];
+		if (!frame.scopes.empty())
+		{
+			ResolveFrame(frame);
+			ReleaseQueries(frame);
+			SyncClocks();
+		}
+
+		frame.frame = m_frame;
+		m_inFrame = true;
+	}
+
+	void GpuProfiler::EndFrame()
+	{
+		if (!m_inFrame)
+		{
+			return;
+		}
+
+		// Scopes still open are closed here so their queries are never orphaned
+		while (!m_openScopes.empty())
+		{
+			EndScope();
+		}
+
+		m_inFrame = false;
+		m_frame++;
+	}
+
+	void GpuProfiler::BeginScope(const char* name)
+	{
+		FrameQueries& frame = m_frames[m_frame % kFrameLatency];
+
+		if (m_debugGroups)
+		{
+			nether::gl::pushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 0, -1, name);
+		}
+
+		PendingScope scope;
+		scope.scope = GetScopeIndex(name);
+		scope.beginQuery = AcquireQuery();
+		scope.depth = int(m_openScopes.size());
+		nether::gl::queryCounter(scope.beginQuery, GL_TIMESTAMP);
+
+		m_openScopes.push_back(int(frame.scopes.size()));
+		frame.scopes.push_back(scope);
+	}
+
+	void GpuProfiler::EndScope()
+	{
+		if (m_openScopes.empty())
+		{
+			return;
+		}
+
+		FrameQueries& frame = m_frames[m_frame % kFrameLatency];
+		PendingScope& scope = frame.scopes[m_openScopes.back()];
+		m_openScopes.pop_back();
+
+		scope.endQuery = AcquireQuery();
+		nether::gl::queryCounter(scope.endQuery, GL_TIMESTAMP);
+		frame.lastQuery = scope.endQuery;
+
+		if (m_debugGroups)
+		{
+			nether::gl::popDebugGroup();
+		}
+	}
+
+	std::vector<GpuScopeStats> GpuProfiler::GetScopeStats() const
+	{
+		std::vector<GpuScopeStats> stats;
+		stats.reserve(m_history.size());
+
+		for (const ScopeHistory& history : m_history)
+		{
+			GpuScopeStats scopeStats;
+			scopeStats.name = history.name;
+			scopeStats.samples = history.count;
+			if (history.count > 0)
+			{
+				double total = 0.0;
+				scopeStats.minMs = history.samples[0];
+				scopeStats.maxMs = history.samples[0];
+				for (int i = 0; i < history.count; i++)
+				{
+					scopeStats.minMs = std::min(scopeStats.minMs, history.samples[i]);
+					scopeStats.maxMs = std::max(scopeStats.maxMs, history.samples[i]);
+					total += history.samples[i];
+				}
+				scopeStats.avgMs = total / history.count;
+				scopeStats.lastMs = history.samples[(history.next + kWindowSize - 1) % kWindowSize];
+			}
+			stats.push_back(scopeStats);
+		}
+		return stats;
+	}
+
+	std::vector<GpuEvent> GpuProfiler::TakeCapturedEvents()
+	{
+		std::vector<GpuEvent> events;
+		events.swap(m_capturedEvents);
+		return events;
+	}
+
+	unsigned int GpuProfiler::AcquireQuery()
+	{
+		if (m_freeQueries.empty())
+		{
+			unsigned int queries[kQueryBatch];
+			nether::gl::genQueries(kQueryBatch, queries);
+			m_allQueries.insert(m_allQueries.end(), queries, queries + kQueryBatch);
+			m_freeQueries.insert(m_freeQueries.end(), queries, queries + kQueryBatch);
+		}
+
+		unsigned int query = m_freeQueries.back();
+		m_freeQueries.pop_back();
+		return query;
+	}
+
+	void GpuProfiler::ResolveFrame(FrameQueries& frame)
+	{
+		// Timestamps complete in order, so if the last one issued is there all of them are
+		int available = 0;
+		nether::gl::getQueryObjectiv(frame.lastQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+		if (!available)
+		{
+			m_droppedFrames++;
+			return;
+		}
+
+		m_lastFrameEvents.clear();
+		for (ScopeHistory& history : m_history)
+		{
+			history.frameTotalMs = 0.0;
+			history.hitThisFrame = false;
+		}
+
+		for (const PendingScope& scope : frame.scopes)
+		{
+			unsigned long long begin = 0, end = 0;
+			nether::gl::getQueryObjectui64v(scope.beginQuery, GL_QUERY_RESULT, &begin);
+			nether::gl::getQueryObjectui64v(scope.endQuery, GL_QUERY_RESULT, &end);
+
+			ScopeHistory& history = m_history[scope.scope];
+			history.frameTotalMs += double(end - begin) * 1e-6;
+			history.hitThisFrame = true;
+
+			GpuEvent event;
+			event.name = history.name;
+			event.frame = frame.frame;
+			event.beginNs = (long long)begin;
+			event.endNs = (long long)end;
+			event.depth = scope.depth;
+			m_lastFrameEvents.push_back(event);
+		}
+
+		for (ScopeHistory& history : m_history)
+		{
+			if (history.hitThisFrame)
+			{
+				history.samples[history.next] = history.frameTotalMs;
+				history.next = (history.next + 1) % kWindowSize;
+				history.count = std::min(history.count + 1, kWindowSize);
+			}
+		}
+
+		if (m_capture)
+		{
+			m_capturedEvents.insert(m_capturedEvents.end(), m_lastFrameEvents.begin(), m_lastFrameEvents.end());
+		}
+	}
+
+	void GpuProfiler::ReleaseQueries(FrameQueries& frame)
+	{
+		for (const PendingScope& scope : frame.scopes)
+		{
+			m_freeQueries.push_back(scope.beginQuery);
+			m_freeQueries.push_back(scope.endQuery);
+		}
+		frame.scopes.clear();
+		frame.lastQuery = 0;
+	}
+
+	void GpuProfiler::SyncClocks()
+	{
+		// glGetInteger64v(GL_TIMESTAMP) reads the GPU clock without waiting for queued work
+		long long gpuNs = 0;
+		nether::gl::getInteger64v(GL_TIMESTAMP, &gpuNs);
+		long long cpuNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+		m_clockOffsetNs = cpuNs - gpuNs;
+	}
+
+	int GpuProfiler::GetScopeIndex(const char* name)
+	{
+		auto byPointer = m_scopeByPointer.find(name);
+		if (byPointer != m_scopeByPointer.end())
+		{
+			return byPointer->second;
+		}
+
+		int index = 0;
+		auto byName = m_scopeByName.find(name);
+		if (byName != m_scopeByName.end())
+		{
+			index = byName->second;
+		}
+		else
+		{
+			index = int(m_history.size());
+			ScopeHistory history;
+			history.name = name;
+			m_history.push_back(history);
+			m_scopeByName.emplace(name, index);
+		}
+
+		m_scopeByPointer.emplace(name, index);
+		return index;
+	}
+
+}
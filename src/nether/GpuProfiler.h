@@ -0,0 +1,209 @@
+#pragma once
+
+#include "nether/NetherGL.h"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace nether
+{
+
+    // One resolved GPU scope. Times are GL_TIMESTAMP nanoseconds on the GPU clock;
+    // add GpuProfiler::GetClockOffset() to move them onto the steady_clock timeline.
+    struct GpuEvent
+    {
+        const char* name = nullptr;
+        unsigned long long frame = 0;
+        long long beginNs = 0;
+        long long endNs = 0;
+        int depth = 0;
+    };
+
+    // Per scope timings over the last GpuProfiler::kWindowSize resolved frames.
+    // A scope entered several times in a frame counts as the sum of its runs.
+    struct GpuScopeStats
+    {
+        const char* name = nullptr;
+        double lastMs = 0.0;
+        double minMs = 0.0;
+        double avgMs = 0.0;
+        double maxMs = 0.0;
+        int samples = 0;
+    };
+
+    // Frame profiler built on GL_TIMESTAMP queries. Every scope writes a timestamp
+    // query when it opens and another when it closes; queries come from a pool and
+    // are tracked per frame in a ring of kFrameLatency frames. A frame is read back
+    // when its slot in the ring comes around again, by which time the GPU has long
+    // finished it, so reading results never stalls the pipeline. If the results are
+    // somehow still not available the frame is dropped rather than waited on.
+    //
+    // Scopes are also pushed as debug groups so they show up in RenderDoc/Nsight.
+    //
+    //  nether::g_gpuProfiler.BeginFrame();
+    //  {
+    //      NETHER_GPU_SCOPE("shadow");
+    //      ... draw ...
+    //  }
+    //  nether::g_gpuProfiler.EndFrame();
+    //
+    // Scope names must outlive the profiler (string literals).
+    class GpuProfiler
+    {
+    public:
+        static constexpr int kFrameLatency = 4;
+        static constexpr int kWindowSize = 120;
+
+        GpuProfiler() = default;
+        GpuProfiler(const GpuProfiler&) = delete;
+        GpuProfiler& operator=(const GpuProfiler&) = delete;
+
+        // Needs a current context; debug groups are only used on GL 4.3+
+        void Init();
+        void Shutdown();
+
+        void BeginFrame();
+        void EndFrame();
+
+        void BeginScope(const char* name);
+        void EndScope();
+
+        void SetEnabled(bool enabled)
+        {
+            m_enabled = enabled;
+        }
+
+        bool IsEnabled() const
+        {
+            return m_enabled;
+        }
+
+        // Scopes are only recorded between BeginFrame and EndFrame
+        bool IsRecording() const
+        {
+            return m_inFrame;
+        }
+
+        void SetDebugGroupsEnabled(bool enabled)
+        {
+            m_debugGroups = enabled && m_debugGroupsSupported;
+        }
+
+        std::vector<GpuScopeStats> GetScopeStats() const;
+
+        // Events of the most recently resolved frame
+        const std::vector<GpuEvent>& GetLastFrameEvents() const
+        {
+            return m_lastFrameEvents;
+        }
+
+        // When capturing, every resolved event is also kept until TakeCapturedEvents
+        void SetCapture(bool capture)
+        {
+            m_capture = capture;
+        }
+
+        std::vector<GpuEvent> TakeCapturedEvents();
+
+        // steady_clock nanoseconds minus GPU timestamp nanoseconds, sampled at Init
+        // and refreshed every frame
+        long long GetClockOffset() const
+        {
+            return m_clockOffsetNs;
+        }
+
+        unsigned long long GetDroppedFrames() const
+        {
+            return m_droppedFrames;
+        }
+
+    private:
+        struct PendingScope
+        {
+            int scope = 0;
+            unsigned int beginQuery = 0;
+            unsigned int endQuery = 0;
+            int depth = 0;
+        };
+
+        struct FrameQueries
+        {
+            unsigned long long frame = 0;
+            std::vector<PendingScope> scopes;
+            // Outer scopes close after inner ones, so this is not scopes.back().endQuery
+            unsigned int lastQuery = 0;
+        };
+
+        struct ScopeHistory
+        {
+            const char* name = nullptr;
+            double samples[kWindowSize] = {};
+            int count = 0;
+            int next = 0;
+            double frameTotalMs = 0.0;
+            bool hitThisFrame = false;
+        };
+
+        unsigned int AcquireQuery();
+        void ResolveFrame(FrameQueries& frame);
+        void ReleaseQueries(FrameQueries& frame);
+        void SyncClocks();
+        int GetScopeIndex(const char* name);
+
+        std::vector<unsigned int> m_freeQueries;
+        std::vector<unsigned int> m_allQueries;
+        FrameQueries m_frames[kFrameLatency];
+        std::vector<int> m_openScopes;
+
+        // Looked up by pointer first, names are usually literals
+        std::unordered_map<const char*, int> m_scopeByPointer;
+        std::unordered_map<std::string, int> m_scopeByName;
+        std::vector<ScopeHistory> m_history;
+
+        std::vector<GpuEvent> m_lastFrameEvents;
+        std::vector<GpuEvent> m_capturedEvents;
+
+        unsigned long long m_frame = 0;
+        unsigned long long m_droppedFrames = 0;
+        long long m_clockOffsetNs = 0;
+        bool m_initialized = false;
+        bool m_enabled = true;
+        bool m_inFrame = false;
+        bool m_capture = false;
+        bool m_debugGroups = false;
+        bool m_debugGroupsSupported = false;
+    };
+
+    extern GpuProfiler g_gpuProfiler;
+
+    class GpuScope
+    {
+    public:
+        explicit GpuScope(const char* name)
+        {
+            if (g_gpuProfiler.IsRecording())
+            {
+                g_gpuProfiler.BeginScope(name);
+                m_active = true;
+            }
+        }
+
+        ~GpuScope()
+        {
+            if (m_active)
+            {
+                g_gpuProfiler.EndScope();
+            }
+        }
+
+        GpuScope(const GpuScope&) = delete;
+        GpuScope& operator=(const GpuScope&) = delete;
+
+    private:
+        bool m_active = false;
+    };
+
+}
+
+#define NETHER_GPU_SCOPE(name) nether::GpuScope NETHER_GL_CONCAT(netherGpuScope_, __LINE__)(name)
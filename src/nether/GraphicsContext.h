@@ -0,0 +1,22 @@
+#pragma once
+
+namespace nether {
+
+	// Owner of the GL context a TestApp renders with. Init makes the context current
+	// and loads the GL entry points, EndFrame presents the frame.
+	class GraphicsContext {
+	public:
+		virtual ~GraphicsContext() = default;
+
+		virtual bool Init(int width, int height) = 0;
+		virtual void EndFrame() = 0;
+		virtual void Cleanup() = 0;
+
+		// Headless contexts have no window and produce no input events
+		virtual bool IsHeadless() const
+		{
+			return false;
+		}
+	};
+
+}
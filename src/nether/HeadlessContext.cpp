@@ -0,0 +1,228 @@
+#ifdef __linux__
+// EGL has to come before glad, which redefines the Khronos platform macros
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+#include "HeadlessContext.h"
+#include "nether/NetherGL.h"
+
+#include <stdio.h>
+#include <string.h>
+
+namespace nether {
+
+#ifdef __linux__
+
+	namespace {
+
+		EGLDisplay GetSurfacelessDisplay()
+		{
+			const char* extensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+			if (extensions == nullptr || strstr(extensions, "EGL_MESA_platform_surfaceless") == nullptr)
+			{
+				return EGL_NO_DISPLAY;
+			}
+
+			auto getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+			if (getPlatformDisplay == nullptr)
+			{
+				return EGL_NO_DISPLAY;
+			}
+			return getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+		}
+
+		EGLContext CreateCoreContext(EGLDisplay display, EGLConfig config)
+		{
+			const int versions[][2] = { { 4, 6 }, { 4, 5 }, { 3, 3 } };
+			for (const auto& version : versions)
+			{
+				const EGLint attributes[] = {
+					EGL_CONTEXT_MAJOR_VERSION, version[0],
+					EGL_CONTEXT_MINOR_VERSION, version[1],
+					EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+					EGL_NONE
+				};
+				EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, attributes);
+				if (context != EGL_NO_CONTEXT)
+				{
+					return context;
+				}
+			}
+			return EGL_NO_CONTEXT;
+		}
+
+	}
+
+	bool HeadlessContext::Init(int width, int height) {
+		EGLDisplay display = GetSurfacelessDisplay();
+		bool surfaceless = display != EGL_NO_DISPLAY;
+		if (!surfaceless)
+		{
+			display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+		}
+
+		EGLint major = 0, minor = 0;
+		if (display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor))
+		{
+			printf("HeadlessContext: no EGL display (0x%x)\n", eglGetError());
+			return false;
+		}
+		m_display = display;
+
+		if (!eglBindAPI(EGL_OPENGL_API))
+		{
+			printf("HeadlessContext: desktop GL not supported by EGL (0x%x)\n", eglGetError());
+			Cleanup();
+			return false;
+		}
+
+		const EGLint configAttributes[] = {
+			EGL_SURFACE_TYPE, surfaceless ? 0 : EGL_PBUFFER_BIT,
+			EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+			EGL_RED_SIZE, 8,
+			EGL_GREEN_SIZE, 8,
+			EGL_BLUE_SIZE, 8,
+			EGL_ALPHA_SIZE, 8,
+			EGL_DEPTH_SIZE, 24,
+			EGL_STENCIL_SIZE, 8,
+			EGL_NONE
+		};
+
+		EGLConfig config = nullptr;
+		EGLint configCount = 0;
+		if (!eglChooseConfig(display, configAttributes, &config, 1, &configCount) || configCount == 0)
+		{
+			// Surfaceless displays may only offer configless contexts
+			config = nullptr;
+			if (!surfaceless)
+			{
+				printf("HeadlessContext: no pbuffer config (0x%x)\n", eglGetError());
+				Cleanup();
+				return false;
+			}
+		}
+
+		EGLContext context = CreateCoreContext(display, config);
+		if (context == EGL_NO_CONTEXT)
+		{
+			printf("HeadlessContext: could not create a core GL context (0x%x)\n", eglGetError());
+			Cleanup();
+			return false;
+		}
+		m_context = context;
+
+		EGLSurface surface = EGL_NO_SURFACE;
+		if (!surfaceless)
+		{
+			const EGLint surfaceAttributes[] = { EGL_WIDTH, width, EGL_HEIGHT, height, EGL_NONE };
+			surface = eglCreatePbufferSurface(display, config, surfaceAttributes);
+			if (surface == EGL_NO_SURFACE)
+			{
+				printf("HeadlessContext: could not create a pbuffer (0x%x)\n", eglGetError());
+				Cleanup();
+				return false;
+			}
+			m_surface = surface;
+		}
+
+		if (!eglMakeCurrent(display, surface, surface, context))
+		{
+			printf("HeadlessContext: eglMakeCurrent failed (0x%x)\n", eglGetError());
+			Cleanup();
+			return false;
+		}
+
+		int version = gladLoadGL((GLADloadfunc)eglGetProcAddress);
+		if (version == 0)
+		{
+			printf("HeadlessContext: failed to load GL\n");
+			Cleanup();
+			return false;
+		}
+		printf("GL %d.%d (headless, %s)\n", GLAD_VERSION_MAJOR(version), GLAD_VERSION_MINOR(version), surfaceless ? "surfaceless" : "pbuffer");
+
+		nether::gl::initializeDirectGL();
+
+		// Without a surface there is no default framebuffer to draw into
+		if (surfaceless && !CreateOffscreenFramebuffer(width, height))
+		{
+			printf("HeadlessContext: offscreen framebuffer is incomplete\n");
+			Cleanup();
+			return false;
+		}
+
+		nether::gl::viewport(0, 0, width, height);
+		return true;
+	}
+
+	bool HeadlessContext::CreateOffscreenFramebuffer(int width, int height) {
+		nether::gl::genRenderbuffers(1, &m_colorRenderbuffer);
+		nether::gl::bindRenderbuffer(GL_RENDERBUFFER, m_colorRenderbuffer);
+		nether::gl::renderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+
+		nether::gl::genRenderbuffers(1, &m_depthRenderbuffer);
+		nether::gl::bindRenderbuffer(GL_RENDERBUFFER, m_depthRenderbuffer);
+		nether::gl::renderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+
+		nether::gl::genFramebuffers(1, &m_framebuffer);
+		nether::gl::bindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+		nether::gl::framebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_colorRenderbuffer);
+		nether::gl::framebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_depthRenderbuffer);
+
+		return nether::gl::checkFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+	}
+
+	void HeadlessContext::EndFrame() {
+		nether::gl::checkFrameErrors();
+		if (m_surface != nullptr)
+		{
+			eglSwapBuffers(m_display, m_surface);
+		}
+		if (m_finishEachFrame)
+		{
+			nether::gl::finish();
+		}
+	}
+
+	void HeadlessContext::Cleanup() {
+		if (m_framebuffer != 0 && eglGetCurrentContext() == m_context)
+		{
+			nether::gl::deleteFramebuffers(1, &m_framebuffer);
+			nether::gl::deleteRenderbuffers(1, &m_colorRenderbuffer);
+			nether::gl::deleteRenderbuffers(1, &m_depthRenderbuffer);
+		}
+		m_framebuffer = m_colorRenderbuffer = m_depthRenderbuffer = 0;
+
+		if (m_display != nullptr)
+		{
+			eglMakeCurrent(m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+			if (m_surface != nullptr)
+			{
+				eglDestroySurface(m_display, m_surface);
+			}
+			if (m_context != nullptr)
+			{
+				eglDestroyContext(m_display, m_context);
+			}
+			eglTerminate(m_display);
+		}
+		m_display = m_surface = m_context = nullptr;
+	}
+
+#else
+
+	bool HeadlessContext::Init(int width, int height) {
+		printf("HeadlessContext: EGL headless rendering is only supported on Linux\n");
+		return false;
+	}
+
+	void HeadlessContext::EndFrame() {
+	}
+
+	void HeadlessContext::Cleanup() {
+	}
+
+#endif
+
+}
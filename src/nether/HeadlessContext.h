@@ -0,0 +1,44 @@
+#pragma once
+
+#include "nether/GraphicsContext.h"
+
+namespace nether {
+
+	// Window-less GL context for build agents without a GPU or display server.
+	// Uses EGL on Mesa: the surfaceless platform when available (rendering goes to
+	// an offscreen framebuffer owned by the context), otherwise a pbuffer surface on
+	// the default display. Works with llvmpipe, which provides GL 4.5 core.
+	class HeadlessContext : public GraphicsContext {
+	public:
+		bool Init(int width, int height) override;
+		void EndFrame() override;
+		void Cleanup() override;
+
+		bool IsHeadless() const override
+		{
+			return true;
+		}
+
+		// Nothing is presented, so frames are only waited for when asked: with this set
+		// EndFrame calls finish, making frame times include the GPU work
+		void SetFinishEachFrame(bool finish)
+		{
+			m_finishEachFrame = finish;
+		}
+
+	private:
+		bool CreateOffscreenFramebuffer(int width, int height);
+
+		// EGL handles, kept opaque so the EGL headers stay out of this header
+		void* m_display = nullptr;
+		void* m_surface = nullptr;
+		void* m_context = nullptr;
+
+		unsigned int m_framebuffer = 0;
+		unsigned int m_colorRenderbuffer = 0;
+		unsigned int m_depthRenderbuffer = 0;
+
+		bool m_finishEachFrame = false;
+	};
+
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <atomic>
+#include <utility>
+
+namespace nether
+{
+
+    // Unbounded lock-free queue for many producer threads and a single consumer
+    // thread (Vyukov's intrusive MPSC list). Push is one atomic exchange and never
+    // waits, so workers can hand results to the render thread without ever blocking
+    // it. Pop can briefly report empty while a push is halfway through; the item is
+    // simply picked up by the next Pop.
+    template <typename T>
+    class MpscQueue
+    {
+    public:
+        MpscQueue()
+        {
+            m_head.store(&m_stub, std::memory_order_relaxed);
+            m_tail = &m_stub;
+        }
+
+        ~MpscQueue()
+        {
+            T item;
+            while (Pop(item))
+            {
+            }
+        }
+
+        MpscQueue(const MpscQueue&) = delete;
+        MpscQueue& operator=(const MpscQueue&) = delete;
+
+        // Any thread
+        void Push(T item)
+        {
+            Node* node = new Node();
+            node->item = std::move(item);
+            PushNode(node);
+        }
+
+        // Consumer thread only
+        bool Pop(T& item)
+        {
+            Node* tail = m_tail;
+            Node* next = tail->next.load(std::memory_order_acquire);
+            if (tail == &m_stub)
+            {
+                if (next == nullptr)
+                {
+                    return false;
+                }
+                m_tail = next;
+                tail = next;
+                next = next->next.load(std::memory_order_acquire);
+            }
+
+            if (next != nullptr)
+            {
+                m_tail = next;
+                item = std::move(tail->item);
+                delete tail;
+                return true;
+            }
+
+            // tail is the last node; put the stub back behind it so it can be taken
+            if (tail != m_head.load(std::memory_order_acquire))
+            {
+                return false;
+            }
+            PushNode(&m_stub);
+
+            next = tail->next.load(std::memory_order_acquire);
+            if (next != nullptr)
+            {
+                m_tail = next;
+                item = std::move(tail->item);
+                delete tail;
+                return true;
+            }
+            return false;
+        }
+
+    private:
+        struct Node
+        {
+            std::atomic<Node*> next { nullptr };
+            T item {};
+        };
+
+        void PushNode(Node* node)
+        {
+            node->next.store(nullptr, std::memory_order_relaxed);
+            Node* previous = m_head.exchange(node, std::memory_order_acq_rel);
+            previous->next.store(node, std::memory_order_release);
+        }
+
+        // Producers append at head, the consumer takes from tail
+        std::atomic<Node*> m_head;
+        Node* m_tail;
+        Node m_stub;
+    };
+
+}
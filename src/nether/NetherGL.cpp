@@ -1,5 +1,9 @@
+// The GLAD loader is compiled into this translation unit only
+#define GLAD_GL_IMPLEMENTATION
 #include "nether/NetherGL.h"
 
+#include <iostream>
+
 namespace nether {
 namespace gl {
 
@@ -8,17 +12,146 @@ OpenGLFunctions* g_gl = nullptr;
 
 #ifdef AETHER_USE_GLAD
 // Direct OpenGL implementation instance
+#ifdef NETHER_GL_BACKEND_GLAD_DIRECT
+// Referenced directly by the convenience functions through NETHER_GL_DISPATCH
+DirectOpenGLFunctions g_directGL;
+static DirectOpenGLFunctions& s_directGL = g_directGL;
+#else
 static DirectOpenGLFunctions s_directGL;
 #endif
+#endif
 
 #ifdef AETHER_USE_QT
 // Qt OpenGL implementation instance - will be created when needed
 static QtOpenGLFunctions* s_qtGL = nullptr;
 #endif
 
+ErrorCheckLevel g_errorCheckLevel = static_cast<ErrorCheckLevel>(NETHER_GL_ERROR_CHECK_LEVEL);
+
+static ErrorCounts s_errorCounts;
+
+// glGetError() returns one flag per call, cap the loop in case the context is lost
+static constexpr int kMaxDrainedErrors = 32;
+
+ErrorCheckLevel setErrorCheckLevel(ErrorCheckLevel level) {
+    if (static_cast<int>(level) > NETHER_GL_ERROR_CHECK_LEVEL) {
+        level = static_cast<ErrorCheckLevel>(NETHER_GL_ERROR_CHECK_LEVEL);
+    }
+    g_errorCheckLevel = level;
+    return g_errorCheckLevel;
+}
+
+const ErrorCounts& getErrorCounts() {
+    return s_errorCounts;
+}
+
+void resetErrorCounts() {
+    s_errorCounts.clear();
+}
+
+const char* getErrorString(unsigned int error) {
+    switch (error) {
+        case 0x0500: // GL_INVALID_ENUM
+            return "GL_INVALID_ENUM";
+        case 0x0501: // GL_INVALID_VALUE
+            return "GL_INVALID_VALUE";
+        case 0x0502: // GL_INVALID_OPERATION
+            return "GL_INVALID_OPERATION";
+        case 0x0503: // GL_STACK_OVERFLOW (deprecated in core profile)
+            return "GL_STACK_OVERFLOW";
+        case 0x0504: // GL_STACK_UNDERFLOW (deprecated in core profile)
+            return "GL_STACK_UNDERFLOW";
+        case 0x0505: // GL_OUT_OF_MEMORY
+            return "GL_OUT_OF_MEMORY";
+        case 0x0506: // GL_INVALID_FRAMEBUFFER_OPERATION
+            return "GL_INVALID_FRAMEBUFFER_OPERATION";
+        case 0x0507: // GL_CONTEXT_LOST
+            return "GL_CONTEXT_LOST";
+        default:
+            return "UNKNOWN_GL_ERROR";
+    }
+}
+
+void recordGLError(const char* functionName, unsigned int error) {
+    s_errorCounts[functionName]++;
+    std::cerr << "[NETHER GL ERROR] " << functionName << " - " << getErrorString(error);
+    if (error < 0x0500 || error > 0x0507) {
+        std::cerr << " (0x" << std::hex << error << std::dec << ")";
+    }
+    std::cerr << std::endl;
+}
+
+int drainGLErrors(const char* label) {
+    if (g_gl == nullptr) {
+        return 0;
+    }
+    int count = 0;
+    for (; count < kMaxDrainedErrors; count++) {
+        unsigned int error = NETHER_GL_DISPATCH.GetError();
+        if (error == 0x0000) {
+            break;
+        }
+        recordGLError(label, error);
+    }
+    return count;
+}
+
+void checkFrameErrors() {
+    if (g_errorCheckLevel >= ErrorCheckLevel::PerFrame) {
+        drainGLErrors("frame");
+    }
+}
+
+StateCache g_stateCache;
+
+void StateCache::Invalidate() {
+    m_program = kUnknown;
+    m_vertexArray = kUnknown;
+    m_activeTexture = kUnknown;
+    m_depthFunc = kUnknown;
+    m_depthMask = kUnknown;
+    for (unsigned int& buffer : m_buffers) buffer = kUnknown;
+    for (auto& unit : m_textures) {
+        for (unsigned int& texture : unit) texture = kUnknown;
+    }
+    for (unsigned int& cap : m_capabilities) cap = kUnknown;
+    for (unsigned int& mode : m_polygonMode) mode = kUnknown;
+    for (unsigned int& factor : m_blendFunc) factor = kUnknown;
+    for (unsigned int& mode : m_blendEquation) mode = kUnknown;
+    for (unsigned int& param : m_pixelStore) param = kUnknown;
+}
+
+void StateCache::OnBuffersDeleted(int n, const unsigned int* buffers) {
+    for (int i = 0; i < n; i++) {
+        for (unsigned int& buffer : m_buffers) {
+            if (buffer == buffers[i]) buffer = 0;
+        }
+    }
+}
+
+void StateCache::OnTexturesDeleted(int n, const unsigned int* textures) {
+    for (int i = 0; i < n; i++) {
+        for (auto& unit : m_textures) {
+            for (unsigned int& texture : unit) {
+                if (texture == textures[i]) texture = 0;
+            }
+        }
+    }
+}
+
+void StateCache::OnVertexArraysDeleted(int n, const unsigned int* arrays) {
+    for (int i = 0; i < n; i++) {
+        if (m_vertexArray == arrays[i]) {
+            m_vertexArray = 0;
+            m_buffers[kElementArraySlot] = kUnknown;
+        }
+    }
+}
+
 void initializeDirectGL() {
 #ifdef AETHER_USE_GLAD
     g_gl = &s_directGL;
+    g_stateCache.Invalidate();
 #else
     // Should not be called without GLAD support
     g_gl = nullptr;
@@ -32,6 +165,7 @@ void initializeQtGL(QOpenGLFunctions_4_5_Core* gl) {
     }
     s_qtGL = new QtOpenGLFunctions(gl);
     g_gl = s_qtGL;
+    g_stateCache.Invalidate();
 }
 #endif
 
@@ -1,31 +1,72 @@
 #pragma once
 
-#define NETHER_GL_ERROR_CHECKING
-
 /*
  * NetherGL - OpenGL abstraction layer with optional error checking
  * 
  * GL Error Checking Feature:
- * To enable automatic GL error checking on each call, define NETHER_GL_ERROR_CHECKING:
+ * Error checking is tiered, from cheapest to most thorough:
  * 
- * Option 1: Uncomment the line below
- * Option 2: Add -DNETHER_GL_ERROR_CHECKING to your compiler flags
- * Option 3: Define it in your build system (CMake, etc.)
+ *   0 - Off:       no glGetError() calls at all
+ *   1 - PerFrame:  errors are drained once per frame by checkFrameErrors()
+ *                  (called from SDLContext::EndFrame)
+ *   2 - PerScope:  errors are also drained around NETHER_GL_ERROR_SCOPE("name")
+ *   3 - PerCall:   every nether::gl:: function checks glGetError() after the call
  * 
- * When enabled, every nether::gl:: function call will automatically check for 
- * OpenGL errors and print them to stderr in the format:
+ * The maximum tier is chosen at build time with NETHER_GL_ERROR_CHECK_LEVEL
+ * (genie: --gl-error-check=off|frame|scope|call). When it is not defined the
+ * legacy NETHER_GL_ERROR_CHECKING define or a debug build (no NDEBUG) selects
+ * PerCall, otherwise checking is Off. At runtime setErrorCheckLevel() can lower
+ * the tier (or raise it back up to the build maximum).
+ * 
+ * Errors are printed to stderr in the format:
  * [NETHER GL ERROR] <function_name> - <error_description>
  * 
  * Example output:
  * [NETHER GL ERROR] bindTexture - GL_INVALID_ENUM
  * 
- * Note: This adds a glGetError() call after each GL function, which can impact 
- * performance, so it's recommended to only enable during development/debugging.
+ * and counted per wrapper function (or scope), see getErrorCounts().
+ * 
+ * Note: PerCall adds a glGetError() call after each GL function, which can
+ * impact performance, so it's recommended to only enable during development/debugging.
+ *
+ * GL Dispatch Backend:
+ * By default every nether::gl:: function calls through the g_gl pointer and the
+ * virtual OpenGLFunctions interface, so the implementation (GLAD or Qt) can be
+ * picked at runtime with initializeDirectGL() / initializeQtGL().
+ *
+ * GLAD-only builds can define NETHER_GL_BACKEND_GLAD_DIRECT (genie: 
+ * --gl-backend=glad_direct) to resolve the calls statically to the GLAD entry
+ * points instead, removing the pointer load and virtual call per GL call.
  */
 
-// Define to enable GL error checking on each call
-// Uncomment the line below to enable GL error checking
-// #define NETHER_GL_ERROR_CHECKING
+#define NETHER_GL_ERROR_CHECK_OFF 0
+#define NETHER_GL_ERROR_CHECK_PER_FRAME 1
+#define NETHER_GL_ERROR_CHECK_PER_SCOPE 2
+#define NETHER_GL_ERROR_CHECK_PER_CALL 3
+
+#ifndef NETHER_GL_ERROR_CHECK_LEVEL
+#if defined(NETHER_GL_ERROR_CHECKING) || !defined(NDEBUG)
+#define NETHER_GL_ERROR_CHECK_LEVEL NETHER_GL_ERROR_CHECK_PER_CALL
+#else
+#define NETHER_GL_ERROR_CHECK_LEVEL NETHER_GL_ERROR_CHECK_OFF
+#endif
+#endif
+
+// NETHER_GL_ERROR_CHECKING guards the per call checks in the wrappers below
+#if NETHER_GL_ERROR_CHECK_LEVEL >= NETHER_GL_ERROR_CHECK_PER_CALL
+#ifndef NETHER_GL_ERROR_CHECKING
+#define NETHER_GL_ERROR_CHECKING
+#endif
+#else
+#undef NETHER_GL_ERROR_CHECKING
+#endif
+
+#if defined(NETHER_GL_BACKEND_GLAD_DIRECT) && !defined(AETHER_USE_GLAD)
+#error "NETHER_GL_BACKEND_GLAD_DIRECT requires AETHER_USE_GLAD"
+#endif
+#if defined(NETHER_GL_BACKEND_GLAD_DIRECT) && defined(AETHER_USE_QT)
+#error "NETHER_GL_BACKEND_GLAD_DIRECT cannot be used in Qt builds, use the default virtual backend"
+#endif
 
 #ifdef AETHER_USE_GLAD
 #include <glad/gl.h>
@@ -37,10 +78,8 @@
 #endif
 
 // Include headers needed for error checking
-#ifdef NETHER_GL_ERROR_CHECKING
-#include <iostream>
 #include <string>
-#endif
+#include <unordered_map>
 
 namespace nether {
 namespace gl {
@@ -72,6 +111,7 @@ public:
     virtual void GetProgramInfoLog(unsigned int program, int bufSize, int* length, char* infoLog) = 0;
     virtual int GetUniformLocation(unsigned int program, const char* name) = 0;
     virtual int GetAttribLocation(unsigned int program, const char* name) = 0;
+    virtual void GetActiveUniform(unsigned int program, unsigned int index, int bufSize, int* length, int* size, unsigned int* type, char* name) = 0;
     
     // Buffer functions
     virtual void GenBuffers(int n, unsigned int* buffers) = 0;
@@ -91,6 +131,7 @@ public:
     virtual void BindTexture(unsigned int target, unsigned int texture) = 0;
     virtual void TexImage2D(unsigned int target, int level, int internalformat, int width, int height, int border, unsigned int format, unsigned int type, const void* pixels) = 0;
     virtual void TexParameteri(unsigned int target, unsigned int pname, int param) = 0;
+    virtual void PixelStorei(unsigned int pname, int param) = 0;
     virtual void DeleteTextures(int n, const unsigned int* textures) = 0;
     virtual void ActiveTexture(unsigned int texture) = 0;
     virtual void GenerateMipmap(unsigned int target) = 0;
@@ -113,6 +154,7 @@ public:
     virtual void Disable(unsigned int cap) = 0;
     virtual void BlendFunc(unsigned int sfactor, unsigned int dfactor) = 0;
     virtual void DepthFunc(unsigned int func) = 0;
+    virtual void DepthMask(unsigned char flag) = 0;
     virtual void CullFace(unsigned int mode) = 0;
     virtual void Clear(unsigned int mask) = 0;
     virtual void ClearColor(float red, float green, float blue, float alpha) = 0;
@@ -120,6 +162,11 @@ public:
     virtual void ClearStencil(int stencil) = 0;
     virtual void Viewport(int x, int y, int width, int height) = 0;
     virtual void PolygonMode(unsigned int face, unsigned int mode) = 0;
+    virtual void GetIntegerv(unsigned int pname, int* data) = 0;
+    virtual void GetIntegeri_v(unsigned int target, unsigned int index, int* data) = 0;
+    virtual void GetInteger64v(unsigned int pname, long long* data) = 0;
+    virtual void Flush() = 0;
+    virtual void Finish() = 0;
     
     // Error checking
     virtual unsigned int GetError() = 0;
@@ -188,6 +235,9 @@ public:
     // Instanced rendering
     virtual void DrawArraysInstanced(unsigned int mode, int first, int count, int instancecount) = 0;
     virtual void DrawElementsInstanced(unsigned int mode, int count, unsigned int type, const void* indices, int instancecount) = 0;
+    virtual void DrawElementsBaseVertex(unsigned int mode, int count, unsigned int type, const void* indices, int basevertex) = 0;
+    virtual void DrawArraysInstancedBaseInstance(unsigned int mode, int first, int count, int instancecount, unsigned int baseinstance) = 0;
+    virtual void DrawElementsInstancedBaseVertexBaseInstance(unsigned int mode, int count, unsigned int type, const void* indices, int instancecount, int basevertex, unsigned int baseinstance) = 0;
     virtual void VertexAttribDivisor(unsigned int index, unsigned int divisor) = 0;
     
     // Advanced vertex attributes
@@ -268,6 +318,10 @@ public:
     virtual unsigned char UnmapBuffer(unsigned int target) = 0;
     virtual void* MapBufferRange(unsigned int target, long long offset, long long length, unsigned int access) = 0;
     virtual void FlushMappedBufferRange(unsigned int target, long long offset, long long length) = 0;
+    virtual void BufferStorage(unsigned int target, long long size, const void* data, unsigned int flags) = 0;
+    virtual void* FenceSync(unsigned int condition, unsigned int flags) = 0;
+    virtual unsigned int ClientWaitSync(void* sync, unsigned int flags, unsigned long long timeout) = 0;
+    virtual void DeleteSync(void* sync) = 0;
     
     // Debug functions (OpenGL 4.3+)
     virtual void DebugMessageControl(unsigned int source, unsigned int type, unsigned int severity, int count, const unsigned int* ids, unsigned char enabled) = 0;
@@ -284,53 +338,9 @@ public:
 
 };
 
-#ifdef NETHER_GL_ERROR_CHECKING
-// GL error checking utility function - now defined after OpenGLFunctions class
-inline void checkGLError(const char* functionName) {
-    unsigned int error = g_gl->GetError();
-    if (error != 0x0000) { // GL_NO_ERROR = 0x0000
-        std::string errorString;
-        switch (error) {
-            case 0x0500: // GL_INVALID_ENUM
-                errorString = "GL_INVALID_ENUM";
-                break;
-            case 0x0501: // GL_INVALID_VALUE
-                errorString = "GL_INVALID_VALUE";
-                break;
-            case 0x0502: // GL_INVALID_OPERATION
-                errorString = "GL_INVALID_OPERATION";
-                break;
-            case 0x0503: // GL_STACK_OVERFLOW (deprecated in core profile)
-                errorString = "GL_STACK_OVERFLOW";
-                break;
-            case 0x0504: // GL_STACK_UNDERFLOW (deprecated in core profile)
-                errorString = "GL_STACK_UNDERFLOW";
-                break;
-            case 0x0505: // GL_OUT_OF_MEMORY
-                errorString = "GL_OUT_OF_MEMORY";
-                break;
-            case 0x0506: // GL_INVALID_FRAMEBUFFER_OPERATION
-                errorString = "GL_INVALID_FRAMEBUFFER_OPERATION";
-                break;
-            case 0x0507: // GL_CONTEXT_LOST
-                errorString = "GL_CONTEXT_LOST";
-                break;
-            default:
-                errorString = "UNKNOWN_GL_ERROR (0x" + std::to_string(error) + ")";
-                break;
-        }
-        std::cerr << "[NETHER GL ERROR] " << functionName << " - " << errorString << std::endl;
-    }
-}
-
-#define NETHER_GL_CHECK(call) do { call; nether::gl::checkGLError(#call); } while(0)
-#else
-#define NETHER_GL_CHECK(call) call
-#endif
-
 #ifdef AETHER_USE_GLAD
 // Direct OpenGL implementation using GLAD
-class DirectOpenGLFunctions : public OpenGLFunctions {
+class DirectOpenGLFunctions final : public OpenGLFunctions {
 public:
     // Shader functions
     unsigned int CreateShader(unsigned int type) override { return glCreateShader(type); }
@@ -350,6 +360,7 @@ public:
     void GetProgramInfoLog(unsigned int program, int bufSize, int* length, char* infoLog) override { glGetProgramInfoLog(program, bufSize, length, infoLog); }
     int GetUniformLocation(unsigned int program, const char* name) override { return glGetUniformLocation(program, name); }
     int GetAttribLocation(unsigned int program, const char* name) override { return glGetAttribLocation(program, name); }
+    void GetActiveUniform(unsigned int program, unsigned int index, int bufSize, int* length, int* size, unsigned int* type, char* name) override { glGetActiveUniform(program, index, bufSize, length, size, type, name); }
     
     // Buffer functions
     void GenBuffers(int n, unsigned int* buffers) override { glGenBuffers(n, buffers); }
@@ -373,6 +384,7 @@ public:
         glTexImage2D(target, level, internalformat, width, height, border, format, type, pixels); 
     }
     void TexParameteri(unsigned int target, unsigned int pname, int param) override { glTexParameteri(target, pname, param); }
+    void PixelStorei(unsigned int pname, int param) override { glPixelStorei(pname, param); }
     void DeleteTextures(int n, const unsigned int* textures) override { glDeleteTextures(n, textures); }
     void ActiveTexture(unsigned int texture) override { glActiveTexture(texture); }
     void GenerateMipmap(unsigned int target) override { glGenerateMipmap(target); }
@@ -395,6 +407,7 @@ public:
     void Disable(unsigned int cap) override { glDisable(cap); }
     void BlendFunc(unsigned int sfactor, unsigned int dfactor) override { glBlendFunc(sfactor, dfactor); }
     void DepthFunc(unsigned int func) override { glDepthFunc(func); }
+    void DepthMask(unsigned char flag) override { glDepthMask(flag); }
     void CullFace(unsigned int mode) override { glCullFace(mode); }
     void Clear(unsigned int mask) override { glClear(mask); }
     void ClearColor(float red, float green, float blue, float alpha) override { glClearColor(red, green, blue, alpha); }
@@ -402,6 +415,11 @@ public:
     void ClearStencil(int stencil) override { glClearStencil(stencil); }
     void Viewport(int x, int y, int width, int height) override { glViewport(x, y, width, height); }
     void PolygonMode(unsigned int face, unsigned int mode) override { glPolygonMode(face, mode); }
+    void GetIntegerv(unsigned int pname, int* data) override { glGetIntegerv(pname, data); }
+    void GetIntegeri_v(unsigned int target, unsigned int index, int* data) override { glGetIntegeri_v(target, index, data); }
+    void GetInteger64v(unsigned int pname, long long* data) override { glGetInteger64v(pname, reinterpret_cast<GLint64*>(data)); }
+    void Flush() override { glFlush(); }
+    void Finish() override { glFinish(); }
     
 
     void CopyTexImage2D(unsigned int target, int level, unsigned int internalformat, int x, int y, int width, int height, int border)
@@ -470,12 +488,15 @@ public:
     void GetQueryObjectiv(unsigned int id, unsigned int pname, int* params) override { glGetQueryObjectiv(id, pname, params); }
     void GetQueryObjectuiv(unsigned int id, unsigned int pname, unsigned int* params) override { glGetQueryObjectuiv(id, pname, params); }
     void QueryCounter(unsigned int id, unsigned int target) override { glQueryCounter(id, target); }
-    void GetQueryObjecti64v(unsigned int id, unsigned int pname, long long* params) override { glGetQueryObjecti64v(id, pname, params); }
-    void GetQueryObjectui64v(unsigned int id, unsigned int pname, unsigned long long* params) override { glGetQueryObjectui64v(id, pname, params); }
+    void GetQueryObjecti64v(unsigned int id, unsigned int pname, long long* params) override { glGetQueryObjecti64v(id, pname, reinterpret_cast<GLint64*>(params)); }
+    void GetQueryObjectui64v(unsigned int id, unsigned int pname, unsigned long long* params) override { glGetQueryObjectui64v(id, pname, reinterpret_cast<GLuint64*>(params)); }
     
     // Instanced rendering
     void DrawArraysInstanced(unsigned int mode, int first, int count, int instancecount) override { glDrawArraysInstanced(mode, first, count, instancecount); }
     void DrawElementsInstanced(unsigned int mode, int count, unsigned int type, const void* indices, int instancecount) override { glDrawElementsInstanced(mode, count, type, indices, instancecount); }
+    void DrawElementsBaseVertex(unsigned int mode, int count, unsigned int type, const void* indices, int basevertex) override { glDrawElementsBaseVertex(mode, count, type, indices, basevertex); }
+    void DrawArraysInstancedBaseInstance(unsigned int mode, int first, int count, int instancecount, unsigned int baseinstance) override { glDrawArraysInstancedBaseInstance(mode, first, count, instancecount, baseinstance); }
+    void DrawElementsInstancedBaseVertexBaseInstance(unsigned int mode, int count, unsigned int type, const void* indices, int instancecount, int basevertex, unsigned int baseinstance) override { glDrawElementsInstancedBaseVertexBaseInstance(mode, count, type, indices, instancecount, basevertex, baseinstance); }
     void VertexAttribDivisor(unsigned int index, unsigned int divisor) override { glVertexAttribDivisor(index, divisor); }
     
     // Advanced vertex attributes
@@ -556,6 +577,10 @@ public:
     unsigned char UnmapBuffer(unsigned int target) override { return glUnmapBuffer(target); }
     void* MapBufferRange(unsigned int target, long long offset, long long length, unsigned int access) override { return glMapBufferRange(target, offset, length, access); }
     void FlushMappedBufferRange(unsigned int target, long long offset, long long length) override { glFlushMappedBufferRange(target, offset, length); }
+    void BufferStorage(unsigned int target, long long size, const void* data, unsigned int flags) override { glBufferStorage(target, size, data, flags); }
+    void* FenceSync(unsigned int condition, unsigned int flags) override { return glFenceSync(condition, flags); }
+    unsigned int ClientWaitSync(void* sync, unsigned int flags, unsigned long long timeout) override { return glClientWaitSync(static_cast<GLsync>(sync), flags, timeout); }
+    void DeleteSync(void* sync) override { glDeleteSync(static_cast<GLsync>(sync)); }
     
     // Debug functions (OpenGL 4.3+)
     void DebugMessageControl(unsigned int source, unsigned int type, unsigned int severity, int count, const unsigned int* ids, unsigned char enabled) override { glDebugMessageControl(source, type, severity, count, ids, enabled); }
@@ -632,6 +657,9 @@ public:
     int GetAttribLocation(unsigned int program, const char* name) override { 
         return m_gl->glGetAttribLocation(program, name);
     }
+    void GetActiveUniform(unsigned int program, unsigned int index, int bufSize, int* length, int* size, unsigned int* type, char* name) override { 
+        m_gl->glGetActiveUniform(program, index, bufSize, length, size, type, name);
+    }
     
     // Buffer functions
     void GenBuffers(int n, unsigned int* buffers) override { 
@@ -677,6 +705,9 @@ public:
     void TexParameteri(unsigned int target, unsigned int pname, int param) override { 
         m_gl->glTexParameteri(target, pname, param);
     }
+    void PixelStorei(unsigned int pname, int param) override { 
+        m_gl->glPixelStorei(pname, param);
+    }
     void DeleteTextures(int n, const unsigned int* textures) override { 
         m_gl->glDeleteTextures(n, textures);
     }
@@ -746,6 +777,9 @@ public:
     void DepthFunc(unsigned int func) override { 
         m_gl->glDepthFunc(func);
     }
+    void DepthMask(unsigned char flag) override { 
+        m_gl->glDepthMask(flag);
+    }
     void CullFace(unsigned int mode) override { 
         m_gl->glCullFace(mode);
     }
@@ -767,6 +801,21 @@ public:
     void PolygonMode(unsigned int face, unsigned int mode) override { 
         m_gl->glPolygonMode(face, mode);
     }
+    void GetIntegerv(unsigned int pname, int* data) override { 
+        m_gl->glGetIntegerv(pname, data);
+    }
+    void GetIntegeri_v(unsigned int target, unsigned int index, int* data) override { 
+        m_gl->glGetIntegeri_v(target, index, data);
+    }
+    void GetInteger64v(unsigned int pname, long long* data) override { 
+        m_gl->glGetInteger64v(pname, reinterpret_cast<GLint64*>(data));
+    }
+    void Flush() override { 
+        m_gl->glFlush();
+    }
+    void Finish() override { 
+        m_gl->glFinish();
+    }
     
     // Error checking
     unsigned int GetError() override { 
@@ -925,6 +974,15 @@ public:
     void DrawElementsInstanced(unsigned int mode, int count, unsigned int type, const void* indices, int instancecount) override { 
         m_gl->glDrawElementsInstanced(mode, count, type, indices, instancecount);
     }
+    void DrawElementsBaseVertex(unsigned int mode, int count, unsigned int type, const void* indices, int basevertex) override { 
+        m_gl->glDrawElementsBaseVertex(mode, count, type, indices, basevertex);
+    }
+    void DrawArraysInstancedBaseInstance(unsigned int mode, int first, int count, int instancecount, unsigned int baseinstance) override { 
+        m_gl->glDrawArraysInstancedBaseInstance(mode, first, count, instancecount, baseinstance);
+    }
+    void DrawElementsInstancedBaseVertexBaseInstance(unsigned int mode, int count, unsigned int type, const void* indices, int instancecount, int basevertex, unsigned int baseinstance) override { 
+        m_gl->glDrawElementsInstancedBaseVertexBaseInstance(mode, count, type, indices, instancecount, basevertex, baseinstance);
+    }
     void VertexAttribDivisor(unsigned int index, unsigned int divisor) override { 
         m_gl->glVertexAttribDivisor(index, divisor);
     }
@@ -1124,6 +1182,18 @@ public:
     void FlushMappedBufferRange(unsigned int target, long long offset, long long length) override { 
         m_gl->glFlushMappedBufferRange(target, offset, length);
     }
+    void BufferStorage(unsigned int target, long long size, const void* data, unsigned int flags) override { 
+        m_gl->glBufferStorage(target, size, data, flags);
+    }
+    void* FenceSync(unsigned int condition, unsigned int flags) override { 
+        return m_gl->glFenceSync(condition, flags);
+    }
+    unsigned int ClientWaitSync(void* sync, unsigned int flags, unsigned long long timeout) override { 
+        return m_gl->glClientWaitSync(static_cast<GLsync>(sync), flags, timeout);
+    }
+    void DeleteSync(void* sync) override { 
+        m_gl->glDeleteSync(static_cast<GLsync>(sync));
+    }
     
     void DebugMessageControl(unsigned int source, unsigned int type, unsigned int severity, int count, const unsigned int* ids, unsigned char enabled) override { 
         m_gl->glDebugMessageControl(source, type, severity, count, ids, enabled);
@@ -1158,9 +1228,367 @@ public:
 // Global OpenGL function pointer - to be set by the application
 extern OpenGLFunctions* g_gl;
 
+// Dispatch target used by the convenience functions below.
+// With NETHER_GL_BACKEND_GLAD_DIRECT the calls go through a concrete, final
+// DirectOpenGLFunctions object, so the compiler resolves and inlines them down
+// to the GLAD entry points. Otherwise they go through the g_gl virtual interface,
+// which is required when the backend is chosen at runtime (Qt or mixed builds).
+#ifdef NETHER_GL_BACKEND_GLAD_DIRECT
+extern DirectOpenGLFunctions g_directGL;
+#define NETHER_GL_DISPATCH (nether::gl::g_directGL)
+#else
+#define NETHER_GL_DISPATCH (*nether::gl::g_gl)
+#endif
+
+// Error checking tiers, see the comment at the top of this file
+enum class ErrorCheckLevel : int {
+    Off = NETHER_GL_ERROR_CHECK_OFF,
+    PerFrame = NETHER_GL_ERROR_CHECK_PER_FRAME,
+    PerScope = NETHER_GL_ERROR_CHECK_PER_SCOPE,
+    PerCall = NETHER_GL_ERROR_CHECK_PER_CALL
+};
+
+// Current runtime tier, never above the build time NETHER_GL_ERROR_CHECK_LEVEL
+extern ErrorCheckLevel g_errorCheckLevel;
+
+// Sets the runtime tier, clamped to the build maximum. Returns the tier in effect.
+ErrorCheckLevel setErrorCheckLevel(ErrorCheckLevel level);
+
+inline ErrorCheckLevel getErrorCheckLevel() {
+    return g_errorCheckLevel;
+}
+
+// Number of errors seen so far, keyed by wrapper function or scope name
+using ErrorCounts = std::unordered_map<std::string, unsigned long long>;
+const ErrorCounts& getErrorCounts();
+void resetErrorCounts();
+
+// Prints and counts an error reported for functionName
+void recordGLError(const char* functionName, unsigned int error);
+const char* getErrorString(unsigned int error);
+
+// Reads every pending error and records it under label. Returns the number of errors.
+int drainGLErrors(const char* label);
+
+// Per frame check, meant to be called once at the end of each frame
+void checkFrameErrors();
+
+#ifdef NETHER_GL_ERROR_CHECKING
+// GL error checking utility function - defined after the backends so it can use NETHER_GL_DISPATCH
+inline void checkGLError(const char* functionName) {
+    if (g_errorCheckLevel < ErrorCheckLevel::PerCall) {
+        return;
+    }
+    unsigned int error = NETHER_GL_DISPATCH.GetError();
+    if (error != 0x0000) { // GL_NO_ERROR = 0x0000
+        recordGLError(functionName, error);
+    }
+}
+
+#define NETHER_GL_CHECK(call) do { call; nether::gl::checkGLError(#call); } while(0)
+#else
+#define NETHER_GL_CHECK(call) call
+#endif
+
+// Drains errors on entry (so earlier ones are not blamed on this scope) and
+// records whatever is raised inside the scope under its name on exit
+class ErrorScope {
+public:
+    explicit ErrorScope(const char* name)
+        : m_name(name)
+    {
+        if (g_errorCheckLevel >= ErrorCheckLevel::PerScope) {
+            drainGLErrors("<before scope>");
+        }
+    }
+
+    ~ErrorScope()
+    {
+        if (g_errorCheckLevel >= ErrorCheckLevel::PerScope) {
+            drainGLErrors(m_name);
+        }
+    }
+
+    ErrorScope(const ErrorScope&) = delete;
+    ErrorScope& operator=(const ErrorScope&) = delete;
+
+private:
+    const char* m_name;
+};
+
+#define NETHER_GL_CONCAT_IMPL(a, b) a##b
+#define NETHER_GL_CONCAT(a, b) NETHER_GL_CONCAT_IMPL(a, b)
+
+#if NETHER_GL_ERROR_CHECK_LEVEL >= NETHER_GL_ERROR_CHECK_PER_SCOPE
+#define NETHER_GL_ERROR_SCOPE(name) nether::gl::ErrorScope NETHER_GL_CONCAT(glErrorScope_, __LINE__)(name)
+#else
+#define NETHER_GL_ERROR_SCOPE(name) do {} while(0)
+#endif
+
+
+// Redundant state elimination
+//
+// The bind/enable/blend/depth/polygon mode/pixel store wrappers below shadow the GL state
+// they set and skip calls that would not change anything. The cache starts
+// out unknown (so the first call of each kind is always issued) and must be
+// invalidated with invalidateStateCache() whenever GL state is changed behind
+// nether's back, e.g. by raw gl* calls or by Qt before each paintGL().
+struct StateCacheStats {
+    unsigned long long issued = 0;
+    unsigned long long elided = 0;
+};
+
+class StateCache {
+public:
+    static constexpr unsigned int kUnknown = 0xFFFFFFFFu;
+    static constexpr int kMaxTextureUnits = 32;
+
+    StateCache() { Invalidate(); }
+
+    void Invalidate();
+
+    void SetEnabled(bool enabled) {
+        m_enabled = enabled;
+        Invalidate();
+    }
+
+    bool IsEnabled() const { return m_enabled; }
+
+    const StateCacheStats& GetStats() const { return m_stats; }
+    void ResetStats() { m_stats = StateCacheStats(); }
+
+    // Each of these returns true when the GL call has to be issued
+
+    bool UseProgram(unsigned int program) {
+        return Update(m_program, program);
+    }
+
+    bool BindVertexArray(unsigned int array) {
+        bool changed = Update(m_vertexArray, array);
+        if (changed) {
+            // The element array binding is part of the vertex array state
+            m_buffers[kElementArraySlot] = kUnknown;
+        }
+        return changed;
+    }
+
+    bool BindBuffer(unsigned int target, unsigned int buffer) {
+        int slot = GetBufferSlot(target);
+        if (slot < 0) {
+            return Issue();
+        }
+        return Update(m_buffers[slot], buffer);
+    }
+
+    // Indexed binds are always issued but also change the generic binding point
+    void OnBufferBoundIndexed(unsigned int target, unsigned int buffer) {
+        int slot = GetBufferSlot(target);
+        if (slot >= 0) {
+            m_buffers[slot] = buffer;
+        }
+    }
+
+    bool ActiveTexture(unsigned int unit) {
+        return Update(m_activeTexture, unit);
+    }
+
+    bool BindTexture(unsigned int target, unsigned int texture) {
+        int slot = GetTextureSlot(target);
+        unsigned int unit = m_activeTexture - GL_TEXTURE0;
+        if (slot < 0 || m_activeTexture == kUnknown || unit >= kMaxTextureUnits) {
+            return Issue();
+        }
+        return Update(m_textures[unit][slot], texture);
+    }
+
+    bool SetCapability(unsigned int cap, bool enabled) {
+        int slot = GetCapabilitySlot(cap);
+        if (slot < 0) {
+            return Issue();
+        }
+        return Update(m_capabilities[slot], enabled ? 1u : 0u);
+    }
+
+    bool PolygonMode(unsigned int face, unsigned int mode) {
+        bool front = face == GL_FRONT || face == GL_FRONT_AND_BACK;
+        bool back = face == GL_BACK || face == GL_FRONT_AND_BACK;
+        if (m_enabled && (!front || m_polygonMode[0] == mode) && (!back || m_polygonMode[1] == mode)) {
+            return Elide();
+        }
+        if (front) m_polygonMode[0] = mode;
+        if (back) m_polygonMode[1] = mode;
+        return Issue();
+    }
+
+    bool BlendFunc(unsigned int srcRGB, unsigned int dstRGB, unsigned int srcAlpha, unsigned int dstAlpha) {
+        return Update(m_blendFunc, { srcRGB, dstRGB, srcAlpha, dstAlpha });
+    }
+
+    bool BlendEquation(unsigned int modeRGB, unsigned int modeAlpha) {
+        return Update(m_blendEquation, { modeRGB, modeAlpha });
+    }
+
+    bool DepthFunc(unsigned int func) {
+        return Update(m_depthFunc, func);
+    }
+
+    bool DepthMask(unsigned char flag) {
+        return Update(m_depthMask, flag ? 1u : 0u);
+    }
+
+    bool PixelStore(unsigned int pname, int param) {
+        int slot = GetPixelStoreSlot(pname);
+        if (slot < 0) {
+            return Issue();
+        }
+        return Update(m_pixelStore[slot], (unsigned int)param);
+    }
+
+    // GL silently unbinds deleted objects, mirror that
+    void OnBuffersDeleted(int n, const unsigned int* buffers);
+    void OnTexturesDeleted(int n, const unsigned int* textures);
+    void OnVertexArraysDeleted(int n, const unsigned int* arrays);
+
+private:
+    static constexpr int kElementArraySlot = 1;
+    static constexpr int kBufferSlotCount = 14;
+    static constexpr int kTextureSlotCount = 7;
+    static constexpr int kCapabilitySlotCount = 15;
+    static constexpr int kPixelStoreSlotCount = 2;
+
+    static int GetBufferSlot(unsigned int target) {
+        switch (target) {
+            case GL_ARRAY_BUFFER: return 0;
+            case GL_ELEMENT_ARRAY_BUFFER: return kElementArraySlot;
+            case GL_COPY_READ_BUFFER: return 2;
+            case GL_COPY_WRITE_BUFFER: return 3;
+            case GL_PIXEL_PACK_BUFFER: return 4;
+            case GL_PIXEL_UNPACK_BUFFER: return 5;
+            case GL_UNIFORM_BUFFER: return 6;
+            case GL_SHADER_STORAGE_BUFFER: return 7;
+            case GL_DRAW_INDIRECT_BUFFER: return 8;
+            case GL_DISPATCH_INDIRECT_BUFFER: return 9;
+            case GL_TEXTURE_BUFFER: return 10;
+            case GL_TRANSFORM_FEEDBACK_BUFFER: return 11;
+            case GL_ATOMIC_COUNTER_BUFFER: return 12;
+            case GL_QUERY_BUFFER: return 13;
+            default: return -1;
+        }
+    }
+
+    static int GetTextureSlot(unsigned int target) {
+        switch (target) {
+            case GL_TEXTURE_2D: return 0;
+            case GL_TEXTURE_3D: return 1;
+            case GL_TEXTURE_CUBE_MAP: return 2;
+            case GL_TEXTURE_2D_ARRAY: return 3;
+            case GL_TEXTURE_2D_MULTISAMPLE: return 4;
+            case GL_TEXTURE_1D: return 5;
+            case GL_TEXTURE_CUBE_MAP_ARRAY: return 6;
+            default: return -1;
+        }
+    }
+
+    static int GetCapabilitySlot(unsigned int cap) {
+        switch (cap) {
+            case GL_DEPTH_TEST: return 0;
+            case GL_BLEND: return 1;
+            case GL_CULL_FACE: return 2;
+            case GL_STENCIL_TEST: return 3;
+            case GL_SCISSOR_TEST: return 4;
+            case GL_POLYGON_OFFSET_FILL: return 5;
+            case GL_MULTISAMPLE: return 6;
+            case GL_FRAMEBUFFER_SRGB: return 7;
+            case GL_PRIMITIVE_RESTART: return 8;
+            case GL_PROGRAM_POINT_SIZE: return 9;
+            case GL_DEPTH_CLAMP: return 10;
+            case GL_RASTERIZER_DISCARD: return 11;
+            case GL_TEXTURE_CUBE_MAP_SEAMLESS: return 12;
+            case GL_DEBUG_OUTPUT: return 13;
+            case GL_DEBUG_OUTPUT_SYNCHRONOUS: return 14;
+            default: return -1;
+        }
+    }
+
+    static int GetPixelStoreSlot(unsigned int pname) {
+        switch (pname) {
+            case GL_UNPACK_ALIGNMENT: return 0;
+            case GL_PACK_ALIGNMENT: return 1;
+            default: return -1;
+        }
+    }
+
+    bool Issue() {
+        m_stats.issued++;
+        return true;
+    }
+
+    bool Elide() {
+        m_stats.elided++;
+        return false;
+    }
+
+    bool Update(unsigned int& cached, unsigned int value) {
+        if (m_enabled && cached == value) {
+            return Elide();
+        }
+        cached = value;
+        return Issue();
+    }
+
+    template <int N>
+    bool Update(unsigned int (&cached)[N], const unsigned int (&value)[N]) {
+        bool same = true;
+        for (int i = 0; i < N; i++) {
+            same = same && cached[i] == value[i];
+        }
+        if (m_enabled && same) {
+            return Elide();
+        }
+        for (int i = 0; i < N; i++) {
+            cached[i] = value[i];
+        }
+        return Issue();
+    }
+
+    bool m_enabled = true;
+    StateCacheStats m_stats;
+
+    unsigned int m_program;
+    unsigned int m_vertexArray;
+    unsigned int m_buffers[kBufferSlotCount];
+    unsigned int m_activeTexture;
+    unsigned int m_textures[kMaxTextureUnits][kTextureSlotCount];
+    unsigned int m_capabilities[kCapabilitySlotCount];
+    unsigned int m_polygonMode[2];
+    unsigned int m_blendFunc[4];
+    unsigned int m_blendEquation[2];
+    unsigned int m_depthFunc;
+    unsigned int m_depthMask;
+    unsigned int m_pixelStore[kPixelStoreSlotCount];
+};
+
+extern StateCache g_stateCache;
+
+inline void invalidateStateCache() {
+    g_stateCache.Invalidate();
+}
+
+inline void setStateCacheEnabled(bool enabled) {
+    g_stateCache.SetEnabled(enabled);
+}
+
+inline const StateCacheStats& getStateCacheStats() {
+    return g_stateCache.GetStats();
+}
+
+inline void resetStateCacheStats() {
+    g_stateCache.ResetStats();
+}
+
 // Convenience functions that use the global function pointer - now with optional error checking
 inline unsigned int createShader(unsigned int type) { 
-    unsigned int result = g_gl->CreateShader(type);
+    unsigned int result = NETHER_GL_DISPATCH.CreateShader(type);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("createShader");
 #endif
@@ -1168,42 +1596,42 @@ inline unsigned int createShader(unsigned int type) {
 }
 
 inline void shaderSource(unsigned int shader, int count, const char* const* string, const int* length) { 
-    g_gl->ShaderSource(shader, count, string, length);
+    NETHER_GL_DISPATCH.ShaderSource(shader, count, string, length);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("shaderSource");
 #endif
 }
 
 inline void compileShader(unsigned int shader) { 
-    g_gl->CompileShader(shader);
+    NETHER_GL_DISPATCH.CompileShader(shader);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("compileShader");
 #endif
 }
 
 inline void deleteShader(unsigned int shader) { 
-    g_gl->DeleteShader(shader);
+    NETHER_GL_DISPATCH.DeleteShader(shader);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("deleteShader");
 #endif
 }
 
 inline void getShaderiv(unsigned int shader, unsigned int pname, int* params) { 
-    g_gl->GetShaderiv(shader, pname, params);
+    NETHER_GL_DISPATCH.GetShaderiv(shader, pname, params);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("getShaderiv");
 #endif
 }
 
 inline void getShaderInfoLog(unsigned int shader, int bufSize, int* length, char* infoLog) { 
-    g_gl->GetShaderInfoLog(shader, bufSize, length, infoLog);
+    NETHER_GL_DISPATCH.GetShaderInfoLog(shader, bufSize, length, infoLog);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("getShaderInfoLog");
 #endif
 }
 
 inline unsigned int createProgram() { 
-    unsigned int result = g_gl->CreateProgram();
+    unsigned int result = NETHER_GL_DISPATCH.CreateProgram();
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("createProgram");
 #endif
@@ -1211,49 +1639,52 @@ inline unsigned int createProgram() {
 }
 
 inline void attachShader(unsigned int program, unsigned int shader) { 
-    g_gl->AttachShader(program, shader);
+    NETHER_GL_DISPATCH.AttachShader(program, shader);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("attachShader");
 #endif
 }
 
 inline void linkProgram(unsigned int program) { 
-    g_gl->LinkProgram(program);
+    NETHER_GL_DISPATCH.LinkProgram(program);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("linkProgram");
 #endif
 }
 
 inline void useProgram(unsigned int program) { 
-    g_gl->UseProgram(program);
+    if (!g_stateCache.UseProgram(program)) {
+        return;
+    }
+    NETHER_GL_DISPATCH.UseProgram(program);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("useProgram");
 #endif
 }
 
 inline void deleteProgram(unsigned int program) { 
-    g_gl->DeleteProgram(program);
+    NETHER_GL_DISPATCH.DeleteProgram(program);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("deleteProgram");
 #endif
 }
 
 inline void getProgramiv(unsigned int program, unsigned int pname, int* params) { 
-    g_gl->GetProgramiv(program, pname, params);
+    NETHER_GL_DISPATCH.GetProgramiv(program, pname, params);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("getProgramiv");
 #endif
 }
 
 inline void getProgramInfoLog(unsigned int program, int bufSize, int* length, char* infoLog) { 
-    g_gl->GetProgramInfoLog(program, bufSize, length, infoLog);
+    NETHER_GL_DISPATCH.GetProgramInfoLog(program, bufSize, length, infoLog);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("getProgramInfoLog");
 #endif
 }
 
 inline int getUniformLocation(unsigned int program, const char* name) { 
-    int result = g_gl->GetUniformLocation(program, name);
+    int result = NETHER_GL_DISPATCH.GetUniformLocation(program, name);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("getUniformLocation");
 #endif
@@ -1261,267 +1692,359 @@ inline int getUniformLocation(unsigned int program, const char* name) {
 }
 
 inline int getAttribLocation(unsigned int program, const char* name) { 
-    int result = g_gl->GetAttribLocation(program, name);
+    int result = NETHER_GL_DISPATCH.GetAttribLocation(program, name);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("getAttribLocation");
 #endif
     return result;
 }
 
+inline void getActiveUniform(unsigned int program, unsigned int index, int bufSize, int* length, int* size, unsigned int* type, char* name) { 
+    NETHER_GL_DISPATCH.GetActiveUniform(program, index, bufSize, length, size, type, name);
+#ifdef NETHER_GL_ERROR_CHECKING
+    checkGLError("getActiveUniform");
+#endif
+}
+
 inline void genBuffers(int n, unsigned int* buffers) { 
-    g_gl->GenBuffers(n, buffers);
+    NETHER_GL_DISPATCH.GenBuffers(n, buffers);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("genBuffers");
 #endif
 }
 
 inline void bindBuffer(unsigned int target, unsigned int buffer) { 
-    g_gl->BindBuffer(target, buffer);
+    if (!g_stateCache.BindBuffer(target, buffer)) {
+        return;
+    }
+    NETHER_GL_DISPATCH.BindBuffer(target, buffer);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("bindBuffer");
 #endif
 }
 
 inline void bufferData(unsigned int target, long long size, const void* data, unsigned int usage) { 
-    g_gl->BufferData(target, size, data, usage);
+    NETHER_GL_DISPATCH.BufferData(target, size, data, usage);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("bufferData");
 #endif
 }
 
 inline void deleteBuffers(int n, const unsigned int* buffers) { 
-    g_gl->DeleteBuffers(n, buffers);
+    NETHER_GL_DISPATCH.DeleteBuffers(n, buffers);
+    g_stateCache.OnBuffersDeleted(n, buffers);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("deleteBuffers");
 #endif
 }
 
 inline void genVertexArrays(int n, unsigned int* arrays) { 
-    g_gl->GenVertexArrays(n, arrays);
+    NETHER_GL_DISPATCH.GenVertexArrays(n, arrays);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("genVertexArrays");
 #endif
 }
 
 inline void bindVertexArray(unsigned int array) { 
-    g_gl->BindVertexArray(array);
+    if (!g_stateCache.BindVertexArray(array)) {
+        return;
+    }
+    NETHER_GL_DISPATCH.BindVertexArray(array);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("bindVertexArray");
 #endif
 }
 
 inline void deleteVertexArrays(int n, const unsigned int* arrays) { 
-    g_gl->DeleteVertexArrays(n, arrays);
+    NETHER_GL_DISPATCH.DeleteVertexArrays(n, arrays);
+    g_stateCache.OnVertexArraysDeleted(n, arrays);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("deleteVertexArrays");
 #endif
 }
 
 inline void enableVertexAttribArray(unsigned int index) { 
-    g_gl->EnableVertexAttribArray(index);
+    NETHER_GL_DISPATCH.EnableVertexAttribArray(index);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("enableVertexAttribArray");
 #endif
 }
 
 inline void vertexAttribPointer(unsigned int index, int size, unsigned int type, unsigned char normalized, int stride, const void* pointer) { 
-    g_gl->VertexAttribPointer(index, size, type, normalized, stride, pointer); 
+    NETHER_GL_DISPATCH.VertexAttribPointer(index, size, type, normalized, stride, pointer); 
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("vertexAttribPointer");
 #endif
 }
 
 inline void genTextures(int n, unsigned int* textures) { 
-    g_gl->GenTextures(n, textures);
+    NETHER_GL_DISPATCH.GenTextures(n, textures);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("genTextures");
 #endif
 }
 
 inline void bindTexture(unsigned int target, unsigned int texture) { 
-    g_gl->BindTexture(target, texture);
+    if (!g_stateCache.BindTexture(target, texture)) {
+        return;
+    }
+    NETHER_GL_DISPATCH.BindTexture(target, texture);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("bindTexture");
 #endif
 }
 
 inline void texImage2D(unsigned int target, int level, int internalformat, int width, int height, int border, unsigned int format, unsigned int type, const void* pixels) { 
-    g_gl->TexImage2D(target, level, internalformat, width, height, border, format, type, pixels); 
+    NETHER_GL_DISPATCH.TexImage2D(target, level, internalformat, width, height, border, format, type, pixels); 
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("texImage2D");
 #endif
 }
 
 inline void texParameteri(unsigned int target, unsigned int pname, int param) { 
-    g_gl->TexParameteri(target, pname, param);
+    NETHER_GL_DISPATCH.TexParameteri(target, pname, param);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("texParameteri");
 #endif
 }
 
+inline void pixelStorei(unsigned int pname, int param) { 
+    if (!g_stateCache.PixelStore(pname, param)) {
+        return;
+    }
+    NETHER_GL_DISPATCH.PixelStorei(pname, param);
+#ifdef NETHER_GL_ERROR_CHECKING
+    checkGLError("pixelStorei");
+#endif
+}
+
 inline void deleteTextures(int n, const unsigned int* textures) { 
-    g_gl->DeleteTextures(n, textures);
+    NETHER_GL_DISPATCH.DeleteTextures(n, textures);
+    g_stateCache.OnTexturesDeleted(n, textures);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("deleteTextures");
 #endif
 }
 
 inline void activeTexture(unsigned int texture) { 
-    g_gl->ActiveTexture(texture);
+    if (!g_stateCache.ActiveTexture(texture)) {
+        return;
+    }
+    NETHER_GL_DISPATCH.ActiveTexture(texture);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("activeTexture");
 #endif
 }
 
 inline void generateMipmap(unsigned int target) { 
-    g_gl->GenerateMipmap(target);
+    NETHER_GL_DISPATCH.GenerateMipmap(target);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("generateMipmap");
 #endif
 }
 
 inline void getTexLevelParameteriv(unsigned int target, int level, unsigned int pname, int* params) { 
-    g_gl->GetTexLevelParameteriv(target, level, pname, params);
+    NETHER_GL_DISPATCH.GetTexLevelParameteriv(target, level, pname, params);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("getTexLevelParameteriv");
 #endif
 }
 
 inline void uniform1i(int location, int v0) { 
-    g_gl->Uniform1i(location, v0);
+    NETHER_GL_DISPATCH.Uniform1i(location, v0);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("uniform1i");
 #endif
 }
 
 inline void uniform1f(int location, float v0) { 
-    g_gl->Uniform1f(location, v0);
+    NETHER_GL_DISPATCH.Uniform1f(location, v0);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("uniform1f");
 #endif
 }
 
 inline void uniform2f(int location, float v0, float v1) { 
-    g_gl->Uniform2f(location, v0, v1);
+    NETHER_GL_DISPATCH.Uniform2f(location, v0, v1);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("uniform2f");
 #endif
 }
 
 inline void uniform3f(int location, float v0, float v1, float v2) { 
-    g_gl->Uniform3f(location, v0, v1, v2);
+    NETHER_GL_DISPATCH.Uniform3f(location, v0, v1, v2);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("uniform3f");
 #endif
 }
 
 inline void uniform4f(int location, float v0, float v1, float v2, float v3) { 
-    g_gl->Uniform4f(location, v0, v1, v2, v3);
+    NETHER_GL_DISPATCH.Uniform4f(location, v0, v1, v2, v3);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("uniform4f");
 #endif
 }
 
 inline void uniformMatrix4fv(int location, int count, unsigned char transpose, const float* value) { 
-    g_gl->UniformMatrix4fv(location, count, transpose, value);
+    NETHER_GL_DISPATCH.UniformMatrix4fv(location, count, transpose, value);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("uniformMatrix4fv");
 #endif
 }
 
 inline void drawElements(unsigned int mode, int count, unsigned int type, const void* indices) { 
-    g_gl->DrawElements(mode, count, type, indices);
+    NETHER_GL_DISPATCH.DrawElements(mode, count, type, indices);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("drawElements");
 #endif
 }
 
 inline void drawArrays(unsigned int mode, int first, int count) { 
-    g_gl->DrawArrays(mode, first, count);
+    NETHER_GL_DISPATCH.DrawArrays(mode, first, count);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("drawArrays");
 #endif
 }
 
 inline void enable(unsigned int cap) { 
-    g_gl->Enable(cap);
+    if (!g_stateCache.SetCapability(cap, true)) {
+        return;
+    }
+    NETHER_GL_DISPATCH.Enable(cap);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("enable");
 #endif
 }
 
 inline void disable(unsigned int cap) { 
-    g_gl->Disable(cap);
+    if (!g_stateCache.SetCapability(cap, false)) {
+        return;
+    }
+    NETHER_GL_DISPATCH.Disable(cap);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("disable");
 #endif
 }
 
 inline void blendFunc(unsigned int sfactor, unsigned int dfactor) { 
-    g_gl->BlendFunc(sfactor, dfactor);
+    if (!g_stateCache.BlendFunc(sfactor, dfactor, sfactor, dfactor)) {
+        return;
+    }
+    NETHER_GL_DISPATCH.BlendFunc(sfactor, dfactor);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("blendFunc");
 #endif
 }
 
 inline void depthFunc(unsigned int func) { 
-    g_gl->DepthFunc(func);
+    if (!g_stateCache.DepthFunc(func)) {
+        return;
+    }
+    NETHER_GL_DISPATCH.DepthFunc(func);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("depthFunc");
 #endif
 }
 
+inline void depthMask(unsigned char flag) { 
+    if (!g_stateCache.DepthMask(flag)) {
+        return;
+    }
+    NETHER_GL_DISPATCH.DepthMask(flag);
+#ifdef NETHER_GL_ERROR_CHECKING
+    checkGLError("depthMask");
+#endif
+}
+
 inline void cullFace(unsigned int mode) { 
-    g_gl->CullFace(mode);
+    NETHER_GL_DISPATCH.CullFace(mode);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("cullFace");
 #endif
 }
 
 inline void clear(unsigned int mask) { 
-    g_gl->Clear(mask);
+    NETHER_GL_DISPATCH.Clear(mask);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("clear");
 #endif
 }
 
 inline void clearColor(float red, float green, float blue, float alpha) { 
-    g_gl->ClearColor(red, green, blue, alpha);
+    NETHER_GL_DISPATCH.ClearColor(red, green, blue, alpha);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("clearColor");
 #endif
 }
 
 inline void clearDepth(double depth) { 
-    g_gl->ClearDepth(depth);
+    NETHER_GL_DISPATCH.ClearDepth(depth);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("clearDepth");
 #endif
 }
 
 inline void clearStencil(int stencil) { 
-    g_gl->ClearStencil(stencil);
+    NETHER_GL_DISPATCH.ClearStencil(stencil);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("clearStencil");
 #endif
 }
 
 inline void viewport(int x, int y, int width, int height) { 
-    g_gl->Viewport(x, y, width, height);
+    NETHER_GL_DISPATCH.Viewport(x, y, width, height);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("viewport");
 #endif
 }
 
 inline void polygonMode(unsigned int face, unsigned int mode) { 
-    g_gl->PolygonMode(face, mode);
+    if (!g_stateCache.PolygonMode(face, mode)) {
+        return;
+    }
+    NETHER_GL_DISPATCH.PolygonMode(face, mode);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("polygonMode");
 #endif
 }
 
+inline void getIntegerv(unsigned int pname, int* data) { 
+    NETHER_GL_DISPATCH.GetIntegerv(pname, data);
+#ifdef NETHER_GL_ERROR_CHECKING
+    checkGLError("getIntegerv");
+#endif
+}
+
+inline void getIntegeri_v(unsigned int target, unsigned int index, int* data) { 
+    NETHER_GL_DISPATCH.GetIntegeri_v(target, index, data);
+#ifdef NETHER_GL_ERROR_CHECKING
+    checkGLError("getIntegeri_v");
+#endif
+}
+
+inline void getInteger64v(unsigned int pname, long long* data) { 
+    NETHER_GL_DISPATCH.GetInteger64v(pname, data);
+#ifdef NETHER_GL_ERROR_CHECKING
+    checkGLError("getInteger64v");
+#endif
+}
+
+inline void flush() { 
+    NETHER_GL_DISPATCH.Flush();
+#ifdef NETHER_GL_ERROR_CHECKING
+    checkGLError("flush");
+#endif
+}
+
+inline void finish() { 
+    NETHER_GL_DISPATCH.Finish();
+#ifdef NETHER_GL_ERROR_CHECKING
+    checkGLError("finish");
+#endif
+}
+
 inline unsigned int getError() { 
-    return g_gl->GetError();
+    return NETHER_GL_DISPATCH.GetError();
     // Note: We don't check for errors on getError() itself to avoid infinite recursion
 }
 
@@ -1529,77 +2052,77 @@ inline unsigned int getError() {
 
 // Framebuffer functions
 inline void genFramebuffers(int n, unsigned int* framebuffers) { 
-    g_gl->GenFramebuffers(n, framebuffers);
+    NETHER_GL_DISPATCH.GenFramebuffers(n, framebuffers);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("genFramebuffers");
 #endif
 }
 
 inline void bindFramebuffer(unsigned int target, unsigned int framebuffer) { 
-    g_gl->BindFramebuffer(target, framebuffer);
+    NETHER_GL_DISPATCH.BindFramebuffer(target, framebuffer);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("bindFramebuffer");
 #endif
 }
 
 inline void deleteFramebuffers(int n, const unsigned int* framebuffers) { 
-    g_gl->DeleteFramebuffers(n, framebuffers);
+    NETHER_GL_DISPATCH.DeleteFramebuffers(n, framebuffers);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("deleteFramebuffers");
 #endif
 }
 
 inline void framebufferTexture2D(unsigned int target, unsigned int attachment, unsigned int textarget, unsigned int texture, int level) { 
-    g_gl->FramebufferTexture2D(target, attachment, textarget, texture, level);
+    NETHER_GL_DISPATCH.FramebufferTexture2D(target, attachment, textarget, texture, level);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("framebufferTexture2D");
 #endif
 }
 
 inline void genRenderbuffers(int n, unsigned int* renderbuffers) { 
-    g_gl->GenRenderbuffers(n, renderbuffers);
+    NETHER_GL_DISPATCH.GenRenderbuffers(n, renderbuffers);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("genRenderbuffers");
 #endif
 }
 
 inline void bindRenderbuffer(unsigned int target, unsigned int renderbuffer) { 
-    g_gl->BindRenderbuffer(target, renderbuffer);
+    NETHER_GL_DISPATCH.BindRenderbuffer(target, renderbuffer);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("bindRenderbuffer");
 #endif
 }
 
 inline void deleteRenderbuffers(int n, const unsigned int* renderbuffers) { 
-    g_gl->DeleteRenderbuffers(n, renderbuffers);
+    NETHER_GL_DISPATCH.DeleteRenderbuffers(n, renderbuffers);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("deleteRenderbuffers");
 #endif
 }
 
 inline void renderbufferStorage(unsigned int target, unsigned int internalformat, int width, int height) { 
-    g_gl->RenderbufferStorage(target, internalformat, width, height);
+    NETHER_GL_DISPATCH.RenderbufferStorage(target, internalformat, width, height);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("renderbufferStorage");
 #endif
 }
 
 inline void renderbufferStorageMultisample(unsigned int target, int samples, unsigned int internalformat, int width, int height) { 
-    g_gl->RenderbufferStorageMultisample(target, samples, internalformat, width, height);
+    NETHER_GL_DISPATCH.RenderbufferStorageMultisample(target, samples, internalformat, width, height);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("renderbufferStorageMultisample");
 #endif
 }
 
 inline void framebufferRenderbuffer(unsigned int target, unsigned int attachment, unsigned int renderbuffertarget, unsigned int renderbuffer) { 
-    g_gl->FramebufferRenderbuffer(target, attachment, renderbuffertarget, renderbuffer);
+    NETHER_GL_DISPATCH.FramebufferRenderbuffer(target, attachment, renderbuffertarget, renderbuffer);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("framebufferRenderbuffer");
 #endif
 }
 
 inline unsigned int checkFramebufferStatus(unsigned int target) { 
-    unsigned int result = g_gl->CheckFramebufferStatus(target);
+    unsigned int result = NETHER_GL_DISPATCH.CheckFramebufferStatus(target);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("checkFramebufferStatus");
 #endif
@@ -1607,21 +2130,21 @@ inline unsigned int checkFramebufferStatus(unsigned int target) {
 }
 
 inline void drawBuffers(int n, const unsigned int* bufs) { 
-    g_gl->DrawBuffers(n, bufs);
+    NETHER_GL_DISPATCH.DrawBuffers(n, bufs);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("drawBuffers");
 #endif
 }
 
 inline void readBuffer(unsigned int mode) { 
-    g_gl->ReadBuffer(mode);
+    NETHER_GL_DISPATCH.ReadBuffer(mode);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("readBuffer");
 #endif
 }
 
 inline void blitFramebuffer(int srcX0, int srcY0, int srcX1, int srcY1, int dstX0, int dstY0, int dstX1, int dstY1, unsigned int mask, unsigned int filter) { 
-    g_gl->BlitFramebuffer(srcX0, srcY0, srcX1, srcY1, dstX0, dstY0, dstX1, dstY1, mask, filter);
+    NETHER_GL_DISPATCH.BlitFramebuffer(srcX0, srcY0, srcX1, srcY1, dstX0, dstY0, dstX1, dstY1, mask, filter);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("blitFramebuffer");
 #endif
@@ -1629,70 +2152,70 @@ inline void blitFramebuffer(int srcX0, int srcY0, int srcX1, int srcY1, int dstX
 
 // Advanced texture functions
 inline void texImage3D(unsigned int target, int level, int internalformat, int width, int height, int depth, int border, unsigned int format, unsigned int type, const void* pixels) { 
-    g_gl->TexImage3D(target, level, internalformat, width, height, depth, border, format, type, pixels);
+    NETHER_GL_DISPATCH.TexImage3D(target, level, internalformat, width, height, depth, border, format, type, pixels);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("texImage3D");
 #endif
 }
 
 inline void texSubImage2D(unsigned int target, int level, int xoffset, int yoffset, int width, int height, unsigned int format, unsigned int type, const void* pixels) { 
-    g_gl->TexSubImage2D(target, level, xoffset, yoffset, width, height, format, type, pixels);
+    NETHER_GL_DISPATCH.TexSubImage2D(target, level, xoffset, yoffset, width, height, format, type, pixels);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("texSubImage2D");
 #endif
 }
 
 inline void texSubImage3D(unsigned int target, int level, int xoffset, int yoffset, int zoffset, int width, int height, int depth, unsigned int format, unsigned int type, const void* pixels) { 
-    g_gl->TexSubImage3D(target, level, xoffset, yoffset, zoffset, width, height, depth, format, type, pixels);
+    NETHER_GL_DISPATCH.TexSubImage3D(target, level, xoffset, yoffset, zoffset, width, height, depth, format, type, pixels);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("texSubImage3D");
 #endif
 }
 
 inline void compressedTexImage2D(unsigned int target, int level, unsigned int internalformat, int width, int height, int border, int imageSize, const void* data) { 
-    g_gl->CompressedTexImage2D(target, level, internalformat, width, height, border, imageSize, data);
+    NETHER_GL_DISPATCH.CompressedTexImage2D(target, level, internalformat, width, height, border, imageSize, data);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("compressedTexImage2D");
 #endif
 }
 
 inline void compressedTexSubImage2D(unsigned int target, int level, int xoffset, int yoffset, int width, int height, unsigned int format, int imageSize, const void* data) { 
-    g_gl->CompressedTexSubImage2D(target, level, xoffset, yoffset, width, height, format, imageSize, data);
+    NETHER_GL_DISPATCH.CompressedTexSubImage2D(target, level, xoffset, yoffset, width, height, format, imageSize, data);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("compressedTexSubImage2D");
 #endif
 }
 
 inline void texStorage2D(unsigned int target, int levels, unsigned int internalformat, int width, int height) { 
-    g_gl->TexStorage2D(target, levels, internalformat, width, height);
+    NETHER_GL_DISPATCH.TexStorage2D(target, levels, internalformat, width, height);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("texStorage2D");
 #endif
 }
 
 inline void texStorage3D(unsigned int target, int levels, unsigned int internalformat, int width, int height, int depth) { 
-    g_gl->TexStorage3D(target, levels, internalformat, width, height, depth);
+    NETHER_GL_DISPATCH.TexStorage3D(target, levels, internalformat, width, height, depth);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("texStorage3D");
 #endif
 }
 
 inline void getTexImage(unsigned int target, int level, unsigned int format, unsigned int type, void* pixels) { 
-    g_gl->GetTexImage(target, level, format, type, pixels);
+    NETHER_GL_DISPATCH.GetTexImage(target, level, format, type, pixels);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("getTexImage");
 #endif
 }
 
 inline void copyTexImage2D(unsigned int target, int level, unsigned int internalformat, int x, int y, int width, int height, int border) { 
-    g_gl->CopyTexImage2D(target, level, internalformat, x, y, width, height, border);
+    NETHER_GL_DISPATCH.CopyTexImage2D(target, level, internalformat, x, y, width, height, border);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("copyTexImage2D");
 #endif
 }
 
 inline void copyTexSubImage2D(unsigned int target, int level, int xoffset, int yoffset, int x, int y, int width, int height) { 
-    g_gl->CopyTexSubImage2D(target, level, xoffset, yoffset, x, y, width, height);
+    NETHER_GL_DISPATCH.CopyTexSubImage2D(target, level, xoffset, yoffset, x, y, width, height);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("copyTexSubImage2D");
 #endif
@@ -1700,21 +2223,23 @@ inline void copyTexSubImage2D(unsigned int target, int level, int xoffset, int y
 
 // Uniform buffer objects
 inline void bindBufferBase(unsigned int target, unsigned int index, unsigned int buffer) { 
-    g_gl->BindBufferBase(target, index, buffer);
+    NETHER_GL_DISPATCH.BindBufferBase(target, index, buffer);
+    g_stateCache.OnBufferBoundIndexed(target, buffer);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("bindBufferBase");
 #endif
 }
 
 inline void bindBufferRange(unsigned int target, unsigned int index, unsigned int buffer, long long offset, long long size) { 
-    g_gl->BindBufferRange(target, index, buffer, offset, size);
+    NETHER_GL_DISPATCH.BindBufferRange(target, index, buffer, offset, size);
+    g_stateCache.OnBufferBoundIndexed(target, buffer);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("bindBufferRange");
 #endif
 }
 
 inline unsigned int getUniformBlockIndex(unsigned int program, const char* uniformBlockName) { 
-    unsigned int result = g_gl->GetUniformBlockIndex(program, uniformBlockName);
+    unsigned int result = NETHER_GL_DISPATCH.GetUniformBlockIndex(program, uniformBlockName);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("getUniformBlockIndex");
 #endif
@@ -1722,14 +2247,14 @@ inline unsigned int getUniformBlockIndex(unsigned int program, const char* unifo
 }
 
 inline void uniformBlockBinding(unsigned int program, unsigned int uniformBlockIndex, unsigned int uniformBlockBinding) { 
-    g_gl->UniformBlockBinding(program, uniformBlockIndex, uniformBlockBinding);
+    NETHER_GL_DISPATCH.UniformBlockBinding(program, uniformBlockIndex, uniformBlockBinding);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("uniformBlockBinding");
 #endif
 }
 
 inline void getActiveUniformBlockiv(unsigned int program, unsigned int uniformBlockIndex, unsigned int pname, int* params) { 
-    g_gl->GetActiveUniformBlockiv(program, uniformBlockIndex, pname, params);
+    NETHER_GL_DISPATCH.GetActiveUniformBlockiv(program, uniformBlockIndex, pname, params);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("getActiveUniformBlockiv");
 #endif
@@ -1737,49 +2262,49 @@ inline void getActiveUniformBlockiv(unsigned int program, unsigned int uniformBl
 
 // Transform feedback
 inline void genTransformFeedbacks(int n, unsigned int* ids) { 
-    g_gl->GenTransformFeedbacks(n, ids);
+    NETHER_GL_DISPATCH.GenTransformFeedbacks(n, ids);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("genTransformFeedbacks");
 #endif
 }
 
 inline void bindTransformFeedback(unsigned int target, unsigned int id) { 
-    g_gl->BindTransformFeedback(target, id);
+    NETHER_GL_DISPATCH.BindTransformFeedback(target, id);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("bindTransformFeedback");
 #endif
 }
 
 inline void deleteTransformFeedbacks(int n, const unsigned int* ids) { 
-    g_gl->DeleteTransformFeedbacks(n, ids);
+    NETHER_GL_DISPATCH.DeleteTransformFeedbacks(n, ids);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("deleteTransformFeedbacks");
 #endif
 }
 
 inline void beginTransformFeedback(unsigned int primitiveMode) { 
-    g_gl->BeginTransformFeedback(primitiveMode);
+    NETHER_GL_DISPATCH.BeginTransformFeedback(primitiveMode);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("beginTransformFeedback");
 #endif
 }
 
 inline void endTransformFeedback() { 
-    g_gl->EndTransformFeedback();
+    NETHER_GL_DISPATCH.EndTransformFeedback();
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("endTransformFeedback");
 #endif
 }
 
 inline void transformFeedbackVaryings(unsigned int program, int count, const char* const* varyings, unsigned int bufferMode) { 
-    g_gl->TransformFeedbackVaryings(program, count, varyings, bufferMode);
+    NETHER_GL_DISPATCH.TransformFeedbackVaryings(program, count, varyings, bufferMode);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("transformFeedbackVaryings");
 #endif
 }
 
 inline void getTransformFeedbackVarying(unsigned int program, unsigned int index, int bufSize, int* length, int* size, unsigned int* type, char* name) { 
-    g_gl->GetTransformFeedbackVarying(program, index, bufSize, length, size, type, name);
+    NETHER_GL_DISPATCH.GetTransformFeedbackVarying(program, index, bufSize, length, size, type, name);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("getTransformFeedbackVarying");
 #endif
@@ -1787,21 +2312,21 @@ inline void getTransformFeedbackVarying(unsigned int program, unsigned int index
 
 // Geometry shader and tessellation functions
 inline void programParameteri(unsigned int program, unsigned int pname, int value) { 
-    g_gl->ProgramParameteri(program, pname, value);
+    NETHER_GL_DISPATCH.ProgramParameteri(program, pname, value);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("programParameteri");
 #endif
 }
 
 inline void patchParameteri(unsigned int pname, int value) { 
-    g_gl->PatchParameteri(pname, value);
+    NETHER_GL_DISPATCH.PatchParameteri(pname, value);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("patchParameteri");
 #endif
 }
 
 inline void patchParameterfv(unsigned int pname, const float* values) { 
-    g_gl->PatchParameterfv(pname, values);
+    NETHER_GL_DISPATCH.PatchParameterfv(pname, values);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("patchParameterfv");
 #endif
@@ -1809,63 +2334,63 @@ inline void patchParameterfv(unsigned int pname, const float* values) {
 
 // Query objects
 inline void genQueries(int n, unsigned int* ids) { 
-    g_gl->GenQueries(n, ids);
+    NETHER_GL_DISPATCH.GenQueries(n, ids);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("genQueries");
 #endif
 }
 
 inline void deleteQueries(int n, const unsigned int* ids) { 
-    g_gl->DeleteQueries(n, ids);
+    NETHER_GL_DISPATCH.DeleteQueries(n, ids);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("deleteQueries");
 #endif
 }
 
 inline void beginQuery(unsigned int target, unsigned int id) { 
-    g_gl->BeginQuery(target, id);
+    NETHER_GL_DISPATCH.BeginQuery(target, id);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("beginQuery");
 #endif
 }
 
 inline void endQuery(unsigned int target) { 
-    g_gl->EndQuery(target);
+    NETHER_GL_DISPATCH.EndQuery(target);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("endQuery");
 #endif
 }
 
 inline void getQueryObjectiv(unsigned int id, unsigned int pname, int* params) { 
-    g_gl->GetQueryObjectiv(id, pname, params);
+    NETHER_GL_DISPATCH.GetQueryObjectiv(id, pname, params);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("getQueryObjectiv");
 #endif
 }
 
 inline void getQueryObjectuiv(unsigned int id, unsigned int pname, unsigned int* params) { 
-    g_gl->GetQueryObjectuiv(id, pname, params);
+    NETHER_GL_DISPATCH.GetQueryObjectuiv(id, pname, params);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("getQueryObjectuiv");
 #endif
 }
 
 inline void queryCounter(unsigned int id, unsigned int target) { 
-    g_gl->QueryCounter(id, target);
+    NETHER_GL_DISPATCH.QueryCounter(id, target);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("queryCounter");
 #endif
 }
 
 inline void getQueryObjecti64v(unsigned int id, unsigned int pname, long long* params) { 
-    g_gl->GetQueryObjecti64v(id, pname, params);
+    NETHER_GL_DISPATCH.GetQueryObjecti64v(id, pname, params);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("getQueryObjecti64v");
 #endif
 }
 
 inline void getQueryObjectui64v(unsigned int id, unsigned int pname, unsigned long long* params) { 
-    g_gl->GetQueryObjectui64v(id, pname, params);
+    NETHER_GL_DISPATCH.GetQueryObjectui64v(id, pname, params);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("getQueryObjectui64v");
 #endif
@@ -1873,21 +2398,42 @@ inline void getQueryObjectui64v(unsigned int id, unsigned int pname, unsigned lo
 
 // Instanced rendering
 inline void drawArraysInstanced(unsigned int mode, int first, int count, int instancecount) { 
-    g_gl->DrawArraysInstanced(mode, first, count, instancecount);
+    NETHER_GL_DISPATCH.DrawArraysInstanced(mode, first, count, instancecount);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("drawArraysInstanced");
 #endif
 }
 
 inline void drawElementsInstanced(unsigned int mode, int count, unsigned int type, const void* indices, int instancecount) { 
-    g_gl->DrawElementsInstanced(mode, count, type, indices, instancecount);
+    NETHER_GL_DISPATCH.DrawElementsInstanced(mode, count, type, indices, instancecount);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("drawElementsInstanced");
 #endif
 }
 
+inline void drawElementsBaseVertex(unsigned int mode, int count, unsigned int type, const void* indices, int basevertex) { 
+    NETHER_GL_DISPATCH.DrawElementsBaseVertex(mode, count, type, indices, basevertex);
+#ifdef NETHER_GL_ERROR_CHECKING
+    checkGLError("drawElementsBaseVertex");
+#endif
+}
+
+inline void drawArraysInstancedBaseInstance(unsigned int mode, int first, int count, int instancecount, unsigned int baseinstance) { 
+    NETHER_GL_DISPATCH.DrawArraysInstancedBaseInstance(mode, first, count, instancecount, baseinstance);
+#ifdef NETHER_GL_ERROR_CHECKING
+    checkGLError("drawArraysInstancedBaseInstance");
+#endif
+}
+
+inline void drawElementsInstancedBaseVertexBaseInstance(unsigned int mode, int count, unsigned int type, const void* indices, int instancecount, int basevertex, unsigned int baseinstance) { 
+    NETHER_GL_DISPATCH.DrawElementsInstancedBaseVertexBaseInstance(mode, count, type, indices, instancecount, basevertex, baseinstance);
+#ifdef NETHER_GL_ERROR_CHECKING
+    checkGLError("drawElementsInstancedBaseVertexBaseInstance");
+#endif
+}
+
 inline void vertexAttribDivisor(unsigned int index, unsigned int divisor) { 
-    g_gl->VertexAttribDivisor(index, divisor);
+    NETHER_GL_DISPATCH.VertexAttribDivisor(index, divisor);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("vertexAttribDivisor");
 #endif
@@ -1895,28 +2441,28 @@ inline void vertexAttribDivisor(unsigned int index, unsigned int divisor) {
 
 // Advanced vertex attributes
 inline void vertexAttribIPointer(unsigned int index, int size, unsigned int type, int stride, const void* pointer) { 
-    g_gl->VertexAttribIPointer(index, size, type, stride, pointer);
+    NETHER_GL_DISPATCH.VertexAttribIPointer(index, size, type, stride, pointer);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("vertexAttribIPointer");
 #endif
 }
 
 inline void vertexAttribLPointer(unsigned int index, int size, unsigned int type, int stride, const void* pointer) { 
-    g_gl->VertexAttribLPointer(index, size, type, stride, pointer);
+    NETHER_GL_DISPATCH.VertexAttribLPointer(index, size, type, stride, pointer);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("vertexAttribLPointer");
 #endif
 }
 
 inline void getVertexAttribIiv(unsigned int index, unsigned int pname, int* params) { 
-    g_gl->GetVertexAttribIiv(index, pname, params);
+    NETHER_GL_DISPATCH.GetVertexAttribIiv(index, pname, params);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("getVertexAttribIiv");
 #endif
 }
 
 inline void getVertexAttribIuiv(unsigned int index, unsigned int pname, unsigned int* params) { 
-    g_gl->GetVertexAttribIuiv(index, pname, params);
+    NETHER_GL_DISPATCH.GetVertexAttribIuiv(index, pname, params);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("getVertexAttribIuiv");
 #endif
@@ -1924,140 +2470,140 @@ inline void getVertexAttribIuiv(unsigned int index, unsigned int pname, unsigned
 
 // Multiple uniform functions
 inline void uniform1iv(int location, int count, const int* value) { 
-    g_gl->Uniform1iv(location, count, value);
+    NETHER_GL_DISPATCH.Uniform1iv(location, count, value);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("uniform1iv");
 #endif
 }
 
 inline void uniform2iv(int location, int count, const int* value) { 
-    g_gl->Uniform2iv(location, count, value);
+    NETHER_GL_DISPATCH.Uniform2iv(location, count, value);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("uniform2iv");
 #endif
 }
 
 inline void uniform3iv(int location, int count, const int* value) { 
-    g_gl->Uniform3iv(location, count, value);
+    NETHER_GL_DISPATCH.Uniform3iv(location, count, value);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("uniform3iv");
 #endif
 }
 
 inline void uniform4iv(int location, int count, const int* value) { 
-    g_gl->Uniform4iv(location, count, value);
+    NETHER_GL_DISPATCH.Uniform4iv(location, count, value);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("uniform4iv");
 #endif
 }
 
 inline void uniform1fv(int location, int count, const float* value) { 
-    g_gl->Uniform1fv(location, count, value);
+    NETHER_GL_DISPATCH.Uniform1fv(location, count, value);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("uniform1fv");
 #endif
 }
 
 inline void uniform2fv(int location, int count, const float* value) { 
-    g_gl->Uniform2fv(location, count, value);
+    NETHER_GL_DISPATCH.Uniform2fv(location, count, value);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("uniform2fv");
 #endif
 }
 
 inline void uniform3fv(int location, int count, const float* value) { 
-    g_gl->Uniform3fv(location, count, value);
+    NETHER_GL_DISPATCH.Uniform3fv(location, count, value);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("uniform3fv");
 #endif
 }
 
 inline void uniform4fv(int location, int count, const float* value) { 
-    g_gl->Uniform4fv(location, count, value);
+    NETHER_GL_DISPATCH.Uniform4fv(location, count, value);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("uniform4fv");
 #endif
 }
 
 inline void uniform1uiv(int location, int count, const unsigned int* value) { 
-    g_gl->Uniform1uiv(location, count, value);
+    NETHER_GL_DISPATCH.Uniform1uiv(location, count, value);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("uniform1uiv");
 #endif
 }
 
 inline void uniform2uiv(int location, int count, const unsigned int* value) { 
-    g_gl->Uniform2uiv(location, count, value);
+    NETHER_GL_DISPATCH.Uniform2uiv(location, count, value);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("uniform2uiv");
 #endif
 }
 
 inline void uniform3uiv(int location, int count, const unsigned int* value) { 
-    g_gl->Uniform3uiv(location, count, value);
+    NETHER_GL_DISPATCH.Uniform3uiv(location, count, value);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("uniform3uiv");
 #endif
 }
 
 inline void uniform4uiv(int location, int count, const unsigned int* value) { 
-    g_gl->Uniform4uiv(location, count, value);
+    NETHER_GL_DISPATCH.Uniform4uiv(location, count, value);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("uniform4uiv");
 #endif
 }
 
 inline void uniformMatrix2fv(int location, int count, unsigned char transpose, const float* value) { 
-    g_gl->UniformMatrix2fv(location, count, transpose, value);
+    NETHER_GL_DISPATCH.UniformMatrix2fv(location, count, transpose, value);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("uniformMatrix2fv");
 #endif
 }
 
 inline void uniformMatrix3fv(int location, int count, unsigned char transpose, const float* value) { 
-    g_gl->UniformMatrix3fv(location, count, transpose, value);
+    NETHER_GL_DISPATCH.UniformMatrix3fv(location, count, transpose, value);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("uniformMatrix3fv");
 #endif
 }
 
 inline void uniformMatrix2x3fv(int location, int count, unsigned char transpose, const float* value) { 
-    g_gl->UniformMatrix2x3fv(location, count, transpose, value);
+    NETHER_GL_DISPATCH.UniformMatrix2x3fv(location, count, transpose, value);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("uniformMatrix2x3fv");
 #endif
 }
 
 inline void uniformMatrix3x2fv(int location, int count, unsigned char transpose, const float* value) { 
-    g_gl->UniformMatrix3x2fv(location, count, transpose, value);
+    NETHER_GL_DISPATCH.UniformMatrix3x2fv(location, count, transpose, value);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("uniformMatrix3x2fv");
 #endif
 }
 
 inline void uniformMatrix2x4fv(int location, int count, unsigned char transpose, const float* value) { 
-    g_gl->UniformMatrix2x4fv(location, count, transpose, value);
+    NETHER_GL_DISPATCH.UniformMatrix2x4fv(location, count, transpose, value);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("uniformMatrix2x4fv");
 #endif
 }
 
 inline void uniformMatrix4x2fv(int location, int count, unsigned char transpose, const float* value) { 
-    g_gl->UniformMatrix4x2fv(location, count, transpose, value);
+    NETHER_GL_DISPATCH.UniformMatrix4x2fv(location, count, transpose, value);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("uniformMatrix4x2fv");
 #endif
 }
 
 inline void uniformMatrix3x4fv(int location, int count, unsigned char transpose, const float* value) { 
-    g_gl->UniformMatrix3x4fv(location, count, transpose, value);
+    NETHER_GL_DISPATCH.UniformMatrix3x4fv(location, count, transpose, value);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("uniformMatrix3x4fv");
 #endif
 }
 
 inline void uniformMatrix4x3fv(int location, int count, unsigned char transpose, const float* value) { 
-    g_gl->UniformMatrix4x3fv(location, count, transpose, value);
+    NETHER_GL_DISPATCH.UniformMatrix4x3fv(location, count, transpose, value);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("uniformMatrix4x3fv");
 #endif
@@ -2065,63 +2611,63 @@ inline void uniformMatrix4x3fv(int location, int count, unsigned char transpose,
 
 // Texture sampler objects
 inline void genSamplers(int count, unsigned int* samplers) { 
-    g_gl->GenSamplers(count, samplers);
+    NETHER_GL_DISPATCH.GenSamplers(count, samplers);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("genSamplers");
 #endif
 }
 
 inline void deleteSamplers(int count, const unsigned int* samplers) { 
-    g_gl->DeleteSamplers(count, samplers);
+    NETHER_GL_DISPATCH.DeleteSamplers(count, samplers);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("deleteSamplers");
 #endif
 }
 
 inline void bindSampler(unsigned int unit, unsigned int sampler) { 
-    g_gl->BindSampler(unit, sampler);
+    NETHER_GL_DISPATCH.BindSampler(unit, sampler);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("bindSampler");
 #endif
 }
 
 inline void samplerParameteri(unsigned int sampler, unsigned int pname, int param) { 
-    g_gl->SamplerParameteri(sampler, pname, param);
+    NETHER_GL_DISPATCH.SamplerParameteri(sampler, pname, param);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("samplerParameteri");
 #endif
 }
 
 inline void samplerParameterf(unsigned int sampler, unsigned int pname, float param) { 
-    g_gl->SamplerParameterf(sampler, pname, param);
+    NETHER_GL_DISPATCH.SamplerParameterf(sampler, pname, param);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("samplerParameterf");
 #endif
 }
 
 inline void samplerParameteriv(unsigned int sampler, unsigned int pname, const int* param) { 
-    g_gl->SamplerParameteriv(sampler, pname, param);
+    NETHER_GL_DISPATCH.SamplerParameteriv(sampler, pname, param);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("samplerParameteriv");
 #endif
 }
 
 inline void samplerParameterfv(unsigned int sampler, unsigned int pname, const float* param) { 
-    g_gl->SamplerParameterfv(sampler, pname, param);
+    NETHER_GL_DISPATCH.SamplerParameterfv(sampler, pname, param);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("samplerParameterfv");
 #endif
 }
 
 inline void getSamplerParameteriv(unsigned int sampler, unsigned int pname, int* params) { 
-    g_gl->GetSamplerParameteriv(sampler, pname, params);
+    NETHER_GL_DISPATCH.GetSamplerParameteriv(sampler, pname, params);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("getSamplerParameteriv");
 #endif
 }
 
 inline void getSamplerParameterfv(unsigned int sampler, unsigned int pname, float* params) { 
-    g_gl->GetSamplerParameterfv(sampler, pname, params);
+    NETHER_GL_DISPATCH.GetSamplerParameterfv(sampler, pname, params);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("getSamplerParameterfv");
 #endif
@@ -2129,21 +2675,21 @@ inline void getSamplerParameterfv(unsigned int sampler, unsigned int pname, floa
 
 // Compute shaders (OpenGL 4.3+)
 inline void dispatchCompute(unsigned int num_groups_x, unsigned int num_groups_y, unsigned int num_groups_z) { 
-    g_gl->DispatchCompute(num_groups_x, num_groups_y, num_groups_z);
+    NETHER_GL_DISPATCH.DispatchCompute(num_groups_x, num_groups_y, num_groups_z);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("dispatchCompute");
 #endif
 }
 
 inline void dispatchComputeIndirect(long long indirect) { 
-    g_gl->DispatchComputeIndirect(indirect);
+    NETHER_GL_DISPATCH.DispatchComputeIndirect(indirect);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("dispatchComputeIndirect");
 #endif
 }
 
 inline void memoryBarrier(unsigned int barriers) { 
-    g_gl->MemoryBarrier(barriers);
+    NETHER_GL_DISPATCH.MemoryBarrier(barriers);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("memoryBarrier");
 #endif
@@ -2151,7 +2697,7 @@ inline void memoryBarrier(unsigned int barriers) {
 
 // Shader storage buffer objects (OpenGL 4.3+)
 inline void shaderStorageBlockBinding(unsigned int program, unsigned int storageBlockIndex, unsigned int storageBlockBinding) { 
-    g_gl->ShaderStorageBlockBinding(program, storageBlockIndex, storageBlockBinding);
+    NETHER_GL_DISPATCH.ShaderStorageBlockBinding(program, storageBlockIndex, storageBlockBinding);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("shaderStorageBlockBinding");
 #endif
@@ -2159,28 +2705,28 @@ inline void shaderStorageBlockBinding(unsigned int program, unsigned int storage
 
 // Multi-draw functions
 inline void multiDrawArrays(unsigned int mode, const int* first, const int* count, int drawcount) { 
-    g_gl->MultiDrawArrays(mode, first, count, drawcount);
+    NETHER_GL_DISPATCH.MultiDrawArrays(mode, first, count, drawcount);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("multiDrawArrays");
 #endif
 }
 
 inline void multiDrawElements(unsigned int mode, const int* count, unsigned int type, const void* const* indices, int drawcount) { 
-    g_gl->MultiDrawElements(mode, count, type, indices, drawcount);
+    NETHER_GL_DISPATCH.MultiDrawElements(mode, count, type, indices, drawcount);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("multiDrawElements");
 #endif
 }
 
 inline void multiDrawArraysIndirect(unsigned int mode, const void* indirect, int drawcount, int stride) { 
-    g_gl->MultiDrawArraysIndirect(mode, indirect, drawcount, stride);
+    NETHER_GL_DISPATCH.MultiDrawArraysIndirect(mode, indirect, drawcount, stride);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("multiDrawArraysIndirect");
 #endif
 }
 
 inline void multiDrawElementsIndirect(unsigned int mode, unsigned int type, const void* indirect, int drawcount, int stride) { 
-    g_gl->MultiDrawElementsIndirect(mode, type, indirect, drawcount, stride);
+    NETHER_GL_DISPATCH.MultiDrawElementsIndirect(mode, type, indirect, drawcount, stride);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("multiDrawElementsIndirect");
 #endif
@@ -2188,14 +2734,14 @@ inline void multiDrawElementsIndirect(unsigned int mode, unsigned int type, cons
 
 // Copy functions
 inline void copyBufferSubData(unsigned int readTarget, unsigned int writeTarget, long long readOffset, long long writeOffset, long long size) { 
-    g_gl->CopyBufferSubData(readTarget, writeTarget, readOffset, writeOffset, size);
+    NETHER_GL_DISPATCH.CopyBufferSubData(readTarget, writeTarget, readOffset, writeOffset, size);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("copyBufferSubData");
 #endif
 }
 
 inline void copyImageSubData(unsigned int srcName, unsigned int srcTarget, int srcLevel, int srcX, int srcY, int srcZ, unsigned int dstName, unsigned int dstTarget, int dstLevel, int dstX, int dstY, int dstZ, int srcWidth, int srcHeight, int srcDepth) { 
-    g_gl->CopyImageSubData(srcName, srcTarget, srcLevel, srcX, srcY, srcZ, dstName, dstTarget, dstLevel, dstX, dstY, dstZ, srcWidth, srcHeight, srcDepth);
+    NETHER_GL_DISPATCH.CopyImageSubData(srcName, srcTarget, srcLevel, srcX, srcY, srcZ, dstName, dstTarget, dstLevel, dstX, dstY, dstZ, srcWidth, srcHeight, srcDepth);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("copyImageSubData");
 #endif
@@ -2203,28 +2749,37 @@ inline void copyImageSubData(unsigned int srcName, unsigned int srcTarget, int s
 
 // Blend functions
 inline void blendEquation(unsigned int mode) { 
-    g_gl->BlendEquation(mode);
+    if (!g_stateCache.BlendEquation(mode, mode)) {
+        return;
+    }
+    NETHER_GL_DISPATCH.BlendEquation(mode);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("blendEquation");
 #endif
 }
 
 inline void blendEquationSeparate(unsigned int modeRGB, unsigned int modeAlpha) { 
-    g_gl->BlendEquationSeparate(modeRGB, modeAlpha);
+    if (!g_stateCache.BlendEquation(modeRGB, modeAlpha)) {
+        return;
+    }
+    NETHER_GL_DISPATCH.BlendEquationSeparate(modeRGB, modeAlpha);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("blendEquationSeparate");
 #endif
 }
 
 inline void blendFuncSeparate(unsigned int sfactorRGB, unsigned int dfactorRGB, unsigned int sfactorAlpha, unsigned int dfactorAlpha) { 
-    g_gl->BlendFuncSeparate(sfactorRGB, dfactorRGB, sfactorAlpha, dfactorAlpha);
+    if (!g_stateCache.BlendFunc(sfactorRGB, dfactorRGB, sfactorAlpha, dfactorAlpha)) {
+        return;
+    }
+    NETHER_GL_DISPATCH.BlendFuncSeparate(sfactorRGB, dfactorRGB, sfactorAlpha, dfactorAlpha);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("blendFuncSeparate");
 #endif
 }
 
 inline void blendColor(float red, float green, float blue, float alpha) { 
-    g_gl->BlendColor(red, green, blue, alpha);
+    NETHER_GL_DISPATCH.BlendColor(red, green, blue, alpha);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("blendColor");
 #endif
@@ -2232,42 +2787,42 @@ inline void blendColor(float red, float green, float blue, float alpha) {
 
 // Stencil functions
 inline void stencilFunc(unsigned int func, int ref, unsigned int mask) { 
-    g_gl->StencilFunc(func, ref, mask);
+    NETHER_GL_DISPATCH.StencilFunc(func, ref, mask);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("stencilFunc");
 #endif
 }
 
 inline void stencilFuncSeparate(unsigned int face, unsigned int func, int ref, unsigned int mask) { 
-    g_gl->StencilFuncSeparate(face, func, ref, mask);
+    NETHER_GL_DISPATCH.StencilFuncSeparate(face, func, ref, mask);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("stencilFuncSeparate");
 #endif
 }
 
 inline void stencilOp(unsigned int fail, unsigned int zfail, unsigned int zpass) { 
-    g_gl->StencilOp(fail, zfail, zpass);
+    NETHER_GL_DISPATCH.StencilOp(fail, zfail, zpass);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("stencilOp");
 #endif
 }
 
 inline void stencilOpSeparate(unsigned int face, unsigned int sfail, unsigned int dpfail, unsigned int dppass) { 
-    g_gl->StencilOpSeparate(face, sfail, dpfail, dppass);
+    NETHER_GL_DISPATCH.StencilOpSeparate(face, sfail, dpfail, dppass);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("stencilOpSeparate");
 #endif
 }
 
 inline void stencilMask(unsigned int mask) { 
-    g_gl->StencilMask(mask);
+    NETHER_GL_DISPATCH.StencilMask(mask);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("stencilMask");
 #endif
 }
 
 inline void stencilMaskSeparate(unsigned int face, unsigned int mask) { 
-    g_gl->StencilMaskSeparate(face, mask);
+    NETHER_GL_DISPATCH.StencilMaskSeparate(face, mask);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("stencilMaskSeparate");
 #endif
@@ -2275,21 +2830,21 @@ inline void stencilMaskSeparate(unsigned int face, unsigned int mask) {
 
 // Advanced buffer functions
 inline void bufferSubData(unsigned int target, long long offset, long long size, const void* data) { 
-    g_gl->BufferSubData(target, offset, size, data);
+    NETHER_GL_DISPATCH.BufferSubData(target, offset, size, data);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("bufferSubData");
 #endif
 }
 
 inline void getBufferSubData(unsigned int target, long long offset, long long size, void* data) { 
-    g_gl->GetBufferSubData(target, offset, size, data);
+    NETHER_GL_DISPATCH.GetBufferSubData(target, offset, size, data);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("getBufferSubData");
 #endif
 }
 
 inline void* mapBuffer(unsigned int target, unsigned int access) { 
-    void* result = g_gl->MapBuffer(target, access);
+    void* result = NETHER_GL_DISPATCH.MapBuffer(target, access);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("mapBuffer");
 #endif
@@ -2297,7 +2852,7 @@ inline void* mapBuffer(unsigned int target, unsigned int access) {
 }
 
 inline unsigned char unmapBuffer(unsigned int target) { 
-    unsigned char result = g_gl->UnmapBuffer(target);
+    unsigned char result = NETHER_GL_DISPATCH.UnmapBuffer(target);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("unmapBuffer");
 #endif
@@ -2305,7 +2860,7 @@ inline unsigned char unmapBuffer(unsigned int target) {
 }
 
 inline void* mapBufferRange(unsigned int target, long long offset, long long length, unsigned int access) { 
-    void* result = g_gl->MapBufferRange(target, offset, length, access);
+    void* result = NETHER_GL_DISPATCH.MapBufferRange(target, offset, length, access);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("mapBufferRange");
 #endif
@@ -2313,36 +2868,66 @@ inline void* mapBufferRange(unsigned int target, long long offset, long long len
 }
 
 inline void flushMappedBufferRange(unsigned int target, long long offset, long long length) { 
-    g_gl->FlushMappedBufferRange(target, offset, length);
+    NETHER_GL_DISPATCH.FlushMappedBufferRange(target, offset, length);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("flushMappedBufferRange");
 #endif
 }
 
+inline void bufferStorage(unsigned int target, long long size, const void* data, unsigned int flags) { 
+    NETHER_GL_DISPATCH.BufferStorage(target, size, data, flags);
+#ifdef NETHER_GL_ERROR_CHECKING
+    checkGLError("bufferStorage");
+#endif
+}
+
+inline void* fenceSync(unsigned int condition, unsigned int flags) { 
+    void* result = NETHER_GL_DISPATCH.FenceSync(condition, flags);
+#ifdef NETHER_GL_ERROR_CHECKING
+    checkGLError("fenceSync");
+#endif
+    return result;
+}
+
+inline unsigned int clientWaitSync(void* sync, unsigned int flags, unsigned long long timeout) { 
+    unsigned int result = NETHER_GL_DISPATCH.ClientWaitSync(sync, flags, timeout);
+#ifdef NETHER_GL_ERROR_CHECKING
+    checkGLError("clientWaitSync");
+#endif
+    return result;
+}
+
+inline void deleteSync(void* sync) { 
+    NETHER_GL_DISPATCH.DeleteSync(sync);
+#ifdef NETHER_GL_ERROR_CHECKING
+    checkGLError("deleteSync");
+#endif
+}
+
 // Debug functions (OpenGL 4.3+)
 inline void debugMessageControl(unsigned int source, unsigned int type, unsigned int severity, int count, const unsigned int* ids, unsigned char enabled) { 
-    g_gl->DebugMessageControl(source, type, severity, count, ids, enabled);
+    NETHER_GL_DISPATCH.DebugMessageControl(source, type, severity, count, ids, enabled);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("debugMessageControl");
 #endif
 }
 
 inline void debugMessageInsert(unsigned int source, unsigned int type, unsigned int id, unsigned int severity, int length, const char* buf) { 
-    g_gl->DebugMessageInsert(source, type, id, severity, length, buf);
+    NETHER_GL_DISPATCH.DebugMessageInsert(source, type, id, severity, length, buf);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("debugMessageInsert");
 #endif
 }
 
 inline void debugMessageCallback(void* callback, const void* userParam) { 
-    g_gl->DebugMessageCallback(callback, userParam);
+    NETHER_GL_DISPATCH.DebugMessageCallback(callback, userParam);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("debugMessageCallback");
 #endif
 }
 
 inline unsigned int debugMessageLog(unsigned int count, int bufSize, unsigned int* sources, unsigned int* types, unsigned int* ids, unsigned int* severities, int* lengths, char* messageLog) { 
-    unsigned int result = g_gl->DebugMessageLog(count, bufSize, sources, types, ids, severities, lengths, messageLog);
+    unsigned int result = NETHER_GL_DISPATCH.DebugMessageLog(count, bufSize, sources, types, ids, severities, lengths, messageLog);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("debugMessageLog");
 #endif
@@ -2350,35 +2935,35 @@ inline unsigned int debugMessageLog(unsigned int count, int bufSize, unsigned in
 }
 
 inline void getDebugMessageLog(unsigned int count, int bufSize, unsigned int* sources, unsigned int* types, unsigned int* ids, unsigned int* severities, int* lengths, char* messageLog) { 
-    g_gl->GetDebugMessageLog(count, bufSize, sources, types, ids, severities, lengths, messageLog);
+    NETHER_GL_DISPATCH.GetDebugMessageLog(count, bufSize, sources, types, ids, severities, lengths, messageLog);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("getDebugMessageLog");
 #endif
 }
 
 inline void pushDebugGroup(unsigned int source, unsigned int id, int length, const char* message) { 
-    g_gl->PushDebugGroup(source, id, length, message);
+    NETHER_GL_DISPATCH.PushDebugGroup(source, id, length, message);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("pushDebugGroup");
 #endif
 }
 
 inline void popDebugGroup() { 
-    g_gl->PopDebugGroup();
+    NETHER_GL_DISPATCH.PopDebugGroup();
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("popDebugGroup");
 #endif
 }
 
 inline void objectLabel(unsigned int identifier, unsigned int name, int length, const char* label) { 
-    g_gl->ObjectLabel(identifier, name, length, label);
+    NETHER_GL_DISPATCH.ObjectLabel(identifier, name, length, label);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("objectLabel");
 #endif
 }
 
 inline void getObjectLabel(unsigned int identifier, unsigned int name, int bufSize, int* length, char* label) { 
-    g_gl->GetObjectLabel(identifier, name, bufSize, length, label);
+    NETHER_GL_DISPATCH.GetObjectLabel(identifier, name, bufSize, length, label);
 #ifdef NETHER_GL_ERROR_CHECKING
     checkGLError("getObjectLabel");
 #endif
@@ -0,0 +1,523 @@
+#include "Renderer.h"
+
+#include <stdio.h>
+
+namespace nether {
+
+	namespace {
+
+		void Draw(const DrawPacket& packet)
+		{
+			const bool instanced = packet.instanceCount != 1 || packet.baseInstance != 0;
+
+			if (packet.indexType == 0)
+			{
+				const int first = int(packet.first);
+				if (!instanced)
+				{
+					nether::gl::drawArrays(packet.primitive, first, packet.count);
+				}
+				else if (packet.baseInstance == 0)
+				{
+					nether::gl::drawArraysInstanced(packet.primitive, first, packet.count, packet.instanceCount);
+				}
+				else
+				{
+					nether::gl::drawArraysInstancedBaseInstance(packet.primitive, first, packet.count, packet.instanceCount, packet.baseInstance);
+				}
+				return;
+			}
+
+			const void* indices = reinterpret_cast<const void*>(packet.first);
+			if (!instanced && packet.baseVertex == 0)
+			{
+				nether::gl::drawElements(packet.primitive, packet.count, packet.indexType, indices);
+			}
+			else if (!instanced)
+			{
+				nether::gl::drawElementsBaseVertex(packet.primitive, packet.count, packet.indexType, indices, packet.baseVertex);
+			}
+			else if (packet.baseVertex == 0 && packet.baseInstance == 0)
+			{
+				nether::gl::drawElementsInstanced(packet.primitive, packet.count, packet.indexType, indices, packet.instanceCount);
+			}
+			else
+			{
+				nether::gl::drawElementsInstancedBaseVertexBaseInstance(packet.primitive, packet.count, packet.indexType, indices,
+					packet.instanceCount, packet.baseVertex, packet.baseInstance);
+			}
+		}
+
+
+		// Packets with their own instancing are drawn as recorded, their transform unused
+		bool UsesTransform(const DrawPacket& packet)
+		{
+			return packet.transform != DrawPacket::kNoTransform && packet.instanceCount == 1 && packet.baseInstance == 0;
+		}
+
+		unsigned int IndexSize(unsigned int indexType)
+		{
+			switch (indexType)
+			{
+			case GL_UNSIGNED_BYTE:
+				return 1;
+			case GL_UNSIGNED_SHORT:
+				return 2;
+			default:
+				return 4;
+			}
+		}
+
+	}
+
+	void Renderer::BeginFrame()
+	{
+		if (instanceBuffer.GetBufferObject() != 0)
+		{
+			instanceBuffer.BeginFrame();
+		}
+		if (indirectBuffer.GetBufferObject() != 0)
+		{
+			indirectBuffer.BeginFrame();
+			drawDataBuffer.BeginFrame();
+		}
+		inFrame = true;
+	}
+
+	void Renderer::EndFrame()
+	{
+		if (!inFrame)
+		{
+			return;
+		}
+
+		if (instanceBuffer.GetBufferObject() != 0)
+		{
+			instanceBuffer.EndFrame();
+		}
+		if (indirectBuffer.GetBufferObject() != 0)
+		{
+			indirectBuffer.EndFrame();
+			drawDataBuffer.EndFrame();
+		}
+		inFrame = false;
+	}
+
+	void Renderer::Submit(const CommandBuffer& commands)
+	{
+		SubmitPackets(commands, nullptr);
+	}
+
+	void Renderer::SubmitSorted(const CommandBuffer& commands)
+	{
+		SortPackets(commands);
+		SubmitPackets(commands, sortItems.data());
+	}
+
+	void Renderer::SubmitIndirect(const CommandBuffer& commands)
+	{
+		SortPackets(commands);
+		SubmitIndirectPackets(commands, sortItems.data());
+	}
+
+	void Renderer::SortPackets(const CommandBuffer& commands)
+	{
+		const std::vector<DrawPacket>& packets = commands.GetPackets();
+
+		sortItems.resize(packets.size());
+		for (size_t i = 0; i < packets.size(); i++)
+		{
+			sortItems[i].key = packets[i].sortKey;
+			sortItems[i].index = (unsigned int)i;
+		}
+		RadixSort(sortItems, sortScratch);
+	}
+
+	void Renderer::InitInstancing(int maxInstancesPerFrame)
+	{
+		instanceBuffer.Generate(BufferBindingTarget::ArrayBuffer, (long long)maxInstancesPerFrame * sizeof(glm::mat4));
+		instancedVaos.clear();
+	}
+
+	void Renderer::ShutdownInstancing()
+	{
+		instanceBuffer.Delete();
+		instancedVaos.clear();
+	}
+
+	void Renderer::InitIndirect(int maxDrawsPerFrame, int maxCallsPerFrame)
+	{
+		// 256 bytes is the largest storage buffer offset alignment in practice
+		indirectBuffer.Generate((long long)maxDrawsPerFrame * sizeof(DrawElementsIndirectCommand));
+		drawDataBuffer.Generate(BufferBindingTarget::ShaderStorageBuffer,
+			(long long)maxDrawsPerFrame * sizeof(glm::mat4) + (long long)maxCallsPerFrame * 256);
+	}
+
+	void Renderer::ShutdownIndirect()
+	{
+		indirectBuffer.Delete();
+		drawDataBuffer.Delete();
+	}
+
+	void Renderer::SubmitPackets(const CommandBuffer& commands, const SortItem* order)
+	{
+		const std::vector<DrawPacket>& packets = commands.GetPackets();
+		const std::vector<glm::mat4>& transforms = commands.GetTransforms();
+		if (packets.empty())
+		{
+			return;
+		}
+
+		const bool instancing = !transforms.empty() && instanceBuffer.GetBufferObject() != 0;
+		if (!transforms.empty() && !instancing && !warnedNoInstancing)
+		{
+			warnedNoInstancing = true;
+			printf("Renderer: packets with transforms need InitInstancing, skipping them\n");
+		}
+
+		// Streamed data is only fenced at EndFrame, a submit outside a frame needs its own
+		const bool ownFrame = !inFrame;
+		if (ownFrame)
+		{
+			BeginFrame();
+		}
+
+		auto packetAt = [&](size_t i) -> const DrawPacket& {
+			return packets[order != nullptr ? order[i].index : i];
+		};
+
+		// What the packets so far have bound, everything is rebound by the first packet
+		DrawPacket bound;
+		bool first = true;
+
+		size_t i = 0;
+		while (i < packets.size())
+		{
+			const DrawPacket& packet = packetAt(i);
+
+			// Consecutive packets that only differ by transform become one instanced draw
+			const bool instanced = UsesTransform(packet);
+			size_t end = i + 1;
+			if (instanced)
+			{
+				while (end < packets.size() && CanInstance(packet, packetAt(end)))
+				{
+					end++;
+				}
+			}
+			const int batchSize = int(end - i);
+			stats.packets += batchSize;
+
+			if (instanced && !instancing)
+			{
+				i = end;
+				continue;
+			}
+
+			BindState(packet, bound, first);
+
+			if (!instanced)
+			{
+				Draw(packet);
+				stats.drawCalls++;
+				i = end;
+				continue;
+			}
+
+			StreamingAllocation allocation = instanceBuffer.Allocate(batchSize * (long long)sizeof(glm::mat4), sizeof(glm::mat4));
+			if (!allocation.IsValid())
+			{
+				stats.droppedInstances += batchSize;
+				i = end;
+				continue;
+			}
+
+			glm::mat4* instanceTransforms = static_cast<glm::mat4*>(allocation.data);
+			for (int instance = 0; instance < batchSize; instance++)
+			{
+				instanceTransforms[instance] = transforms[packetAt(i + instance).transform];
+			}
+
+			SetupInstancedVao(packet.vao);
+
+			// The instance attributes start at the buffer's beginning, baseInstance
+			// selects this batch's transforms
+			DrawPacket batch = packet;
+			batch.instanceCount = batchSize;
+			batch.baseInstance = (unsigned int)(allocation.offset / (long long)sizeof(glm::mat4));
+			Draw(batch);
+
+			stats.drawCalls++;
+			stats.instancedDraws++;
+			stats.instances += batchSize;
+			i = end;
+		}
+
+		if (ownFrame)
+		{
+			EndFrame();
+		}
+	}
+
+	void Renderer::SubmitIndirectPackets(const CommandBuffer& commands, const SortItem* order)
+	{
+		const std::vector<DrawPacket>& packets = commands.GetPackets();
+		const std::vector<glm::mat4>& transforms = commands.GetTransforms();
+		if (packets.empty())
+		{
+			return;
+		}
+
+		const bool indirect = indirectBuffer.GetBufferObject() != 0;
+		if (!indirect && !warnedNoIndirect)
+		{
+			warnedNoIndirect = true;
+			printf("Renderer: SubmitIndirect needs InitIndirect, skipping packets with transforms\n");
+		}
+		if (indirect)
+		{
+			// Not VAO state, stays bound for the whole submit
+			indirectBuffer.Bind();
+		}
+
+		// Streamed data is only fenced at EndFrame, a submit outside a frame needs its own
+		const bool ownFrame = !inFrame;
+		if (ownFrame)
+		{
+			BeginFrame();
+		}
+
+		auto packetAt = [&](size_t i) -> const DrawPacket& {
+			return packets[order[i].index];
+		};
+
+		DrawPacket bound;
+		bool first = true;
+
+		size_t i = 0;
+		while (i < packets.size())
+		{
+			const DrawPacket& packet = packetAt(i);
+
+			// Consecutive packets sharing all bound state become one multi draw call
+			const bool multiDraw = UsesTransform(packet);
+			size_t end = i + 1;
+			if (multiDraw)
+			{
+				while (end < packets.size() && CanMultiDraw(packet, packetAt(end)))
+				{
+					end++;
+				}
+			}
+			const int drawCount = int(end - i);
+			stats.packets += drawCount;
+
+			if (multiDraw && !indirect)
+			{
+				i = end;
+				continue;
+			}
+
+			BindState(packet, bound, first);
+
+			if (!multiDraw)
+			{
+				Draw(packet);
+				stats.drawCalls++;
+				i = end;
+				continue;
+			}
+
+			StreamingAllocation drawData = drawDataBuffer.Allocate(drawCount * (long long)sizeof(glm::mat4), sizeof(glm::mat4));
+			long long commandOffset = -1;
+			if (drawData.IsValid())
+			{
+				if (packet.indexType != 0)
+				{
+					const unsigned int indexSize = IndexSize(packet.indexType);
+					elementCommands.resize(drawCount);
+					for (int draw = 0; draw < drawCount; draw++)
+					{
+						const DrawPacket& drawPacket = packetAt(i + draw);
+						DrawElementsIndirectCommand& command = elementCommands[draw];
+						command.count = (unsigned int)drawPacket.count;
+						command.instanceCount = 1;
+						command.firstIndex = (unsigned int)(drawPacket.first / indexSize);
+						command.baseVertex = drawPacket.baseVertex;
+						command.baseInstance = 0;
+					}
+					commandOffset = indirectBuffer.Write(std::span<const DrawElementsIndirectCommand>(elementCommands));
+				}
+				else
+				{
+					arrayCommands.resize(drawCount);
+					for (int draw = 0; draw < drawCount; draw++)
+					{
+						const DrawPacket& drawPacket = packetAt(i + draw);
+						DrawArraysIndirectCommand& command = arrayCommands[draw];
+						command.count = (unsigned int)drawPacket.count;
+						command.instanceCount = 1;
+						command.first = (unsigned int)drawPacket.first;
+						command.baseInstance = 0;
+					}
+					commandOffset = indirectBuffer.Write(std::span<const DrawArraysIndirectCommand>(arrayCommands));
+				}
+			}
+			if (commandOffset < 0)
+			{
+				stats.droppedDraws += drawCount;
+				i = end;
+				continue;
+			}
+
+			glm::mat4* drawTransforms = static_cast<glm::mat4*>(drawData.data);
+			for (int draw = 0; draw < drawCount; draw++)
+			{
+				drawTransforms[draw] = transforms[packetAt(i + draw).transform];
+			}
+
+			// gl_DrawID restarts at 0 for every call, so the range starts at this call's draws
+			nether::gl::bindBufferRange(GL_SHADER_STORAGE_BUFFER, kDrawDataBinding, drawDataBuffer.GetBufferObject(),
+				drawData.offset, drawData.size);
+
+			if (packet.indexType != 0)
+			{
+				DrawIndirectBuffer::MultiDrawElements(packet.primitive, packet.indexType, commandOffset, drawCount);
+			}
+			else
+			{
+				DrawIndirectBuffer::MultiDrawArrays(packet.primitive, commandOffset, drawCount);
+			}
+
+			stats.drawCalls++;
+			stats.multiDrawCalls++;
+			stats.indirectDraws += drawCount;
+			i = end;
+		}
+
+		if (ownFrame)
+		{
+			EndFrame();
+		}
+	}
+
+	void Renderer::BindState(const DrawPacket& packet, DrawPacket& bound, bool& first)
+	{
+		if (first || packet.program != bound.program)
+		{
+			nether::gl::useProgram(packet.program);
+			bound.program = packet.program;
+			stats.programChanges++;
+		}
+
+		if (first || packet.vao != bound.vao)
+		{
+			nether::gl::bindVertexArray(packet.vao);
+			bound.vao = packet.vao;
+			stats.vaoChanges++;
+		}
+
+		for (int unit = 0; unit < DrawPacket::kMaxTextures; unit++)
+		{
+			const unsigned int texture = packet.textures[unit];
+			if (texture != 0 && (first || texture != bound.textures[unit]))
+			{
+				nether::gl::activeTexture(GL_TEXTURE0 + unit);
+				nether::gl::bindTexture(GL_TEXTURE_2D, texture);
+				bound.textures[unit] = texture;
+				stats.textureChanges++;
+			}
+		}
+
+		if (packet.uniformBuffer != 0 && (first
+			|| packet.uniformBuffer != bound.uniformBuffer
+			|| packet.uniformBinding != bound.uniformBinding
+			|| packet.uniformOffset != bound.uniformOffset
+			|| packet.uniformSize != bound.uniformSize))
+		{
+			nether::gl::bindBufferRange(GL_UNIFORM_BUFFER, packet.uniformBinding, packet.uniformBuffer,
+				packet.uniformOffset, packet.uniformSize);
+			bound.uniformBuffer = packet.uniformBuffer;
+			bound.uniformBinding = packet.uniformBinding;
+			bound.uniformOffset = packet.uniformOffset;
+			bound.uniformSize = packet.uniformSize;
+			stats.uniformRangeChanges++;
+		}
+		first = false;
+	}
+
+	bool Renderer::CanInstance(const DrawPacket& batch, const DrawPacket& packet)
+	{
+		if (!UsesTransform(packet))
+		{
+			return false;
+		}
+
+		for (int unit = 0; unit < DrawPacket::kMaxTextures; unit++)
+		{
+			if (packet.textures[unit] != batch.textures[unit])
+			{
+				return false;
+			}
+		}
+
+		return packet.program == batch.program
+			&& packet.vao == batch.vao
+			&& packet.primitive == batch.primitive
+			&& packet.indexType == batch.indexType
+			&& packet.first == batch.first
+			&& packet.count == batch.count
+			&& packet.baseVertex == batch.baseVertex
+			&& packet.uniformBuffer == batch.uniformBuffer
+			&& packet.uniformBinding == batch.uniformBinding
+			&& packet.uniformOffset == batch.uniformOffset
+			&& packet.uniformSize == batch.uniformSize;
+	}
+
+	bool Renderer::CanMultiDraw(const DrawPacket& batch, const DrawPacket& packet)
+	{
+		if (!UsesTransform(packet))
+		{
+			return false;
+		}
+
+		for (int unit = 0; unit < DrawPacket::kMaxTextures; unit++)
+		{
+			if (packet.textures[unit] != batch.textures[unit])
+			{
+				return false;
+			}
+		}
+
+		// Unlike instancing, the vertex ranges may differ
+		return packet.program == batch.program
+			&& packet.vao == batch.vao
+			&& packet.primitive == batch.primitive
+			&& packet.indexType == batch.indexType
+			&& packet.uniformBuffer == batch.uniformBuffer
+			&& packet.uniformBinding == batch.uniformBinding
+			&& packet.uniformOffset == batch.uniformOffset
+			&& packet.uniformSize == batch.uniformSize;
+	}
+
+	void Renderer::SetupInstancedVao(unsigned int vao)
+	{
+		if (instancedVaos.count(vao) != 0)
+		{
+			return;
+		}
+
+		// The VAO keeps the instance buffer binding with the attribute, so this is once per VAO
+		nether::gl::bindBuffer(GL_ARRAY_BUFFER, instanceBuffer.GetBufferObject());
+		for (unsigned int column = 0; column < 4; column++)
+		{
+			const unsigned int location = kInstanceTransformLocation + column;
+			nether::gl::enableVertexAttribArray(location);
+			nether::gl::vertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4),
+				reinterpret_cast<const void*>(column * sizeof(glm::vec4)));
+			nether::gl::vertexAttribDivisor(location, 1);
+		}
+		instancedVaos.insert(vao);
+	}
+
+}
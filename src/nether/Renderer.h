@@ -1,7 +1,11 @@
 #pragma once
 
 #include "nether/Color.h"
+#include "nether/CommandBuffer.h"
+#include "nether/DrawIndirectBuffer.h"
+#include "nether/SortKey.h"
 
+#include <unordered_set>
 #include <vector>
 #include <nether/NetherGL.h>
 
@@ -20,9 +24,36 @@ namespace nether
     
     };
 
+    // Accumulated by Submit until ResetStats. A change is counted whenever a packet
+    // needs different state than what earlier packets left bound.
+    struct RenderStats
+    {
+        unsigned long long packets = 0;
+        unsigned long long drawCalls = 0;
+        unsigned long long programChanges = 0;
+        unsigned long long vaoChanges = 0;
+        unsigned long long textureChanges = 0;
+        unsigned long long uniformRangeChanges = 0;
+        unsigned long long instancedDraws = 0;
+        unsigned long long instances = 0;
+        // Instances that did not fit in the instance buffer and were not drawn
+        unsigned long long droppedInstances = 0;
+        unsigned long long multiDrawCalls = 0;
+        // Draws issued through multi draw indirect calls
+        unsigned long long indirectDraws = 0;
+        // Draws that did not fit in the indirect or draw data buffers and were not drawn
+        unsigned long long droppedDraws = 0;
+    };
+
     class Renderer
     {
     public:
+        // First of the four vec4 attribute locations holding the instance transform:
+        // layout (location = 4) in mat4 instanceModel;
+        static constexpr unsigned int kInstanceTransformLocation = 4;
+
+        // Shader storage binding of the per draw transforms read by SubmitIndirect draws
+        static constexpr unsigned int kDrawDataBinding = 2;
 
         void SetRendererClearColor(Color color)
         {
@@ -35,6 +66,13 @@ namespace nether
             nether::gl::clear(clearBitField);
         }
 
+        // Bracket every Submit of a frame (shadow, main, UI...). The instance, indirect
+        // and draw data buffers move to their next region in BeginFrame, which waits on
+        // the fence of the frame that last used it, and all of the frame's submits
+        // sub-allocate from that region. A Submit outside a frame is a frame of its own.
+        void BeginFrame();
+        void EndFrame();
+
         void SetColorBufferBit(bool set)
         {
             colorBufferBit = set;
@@ -91,8 +129,78 @@ namespace nether
             UpdatePolygonMode();
         }
 
+        // Issues the packets in order, only binding what differs from the previous
+        // packet. State is assumed unknown at the start of each Submit.
+        //
+        // Packets with a transform are merged with the following packets that differ
+        // only by their transform into one instanced draw. Their transforms are
+        // written to the instance buffer and read through per instance attributes
+        // at kInstanceTransformLocation, selected with baseInstance, so the VAO's
+        // attribute setup never changes. Requires InitInstancing. Packets with their
+        // own instancing (SetInstances) are drawn as recorded, ignoring any transform.
+        void Submit(const CommandBuffer& commands);
+
+        // Same as Submit, but in ascending DrawPacket::sortKey order. Packets with
+        // equal keys keep their recording order.
+        void SubmitSorted(const CommandBuffer& commands);
+
+        // Sorts like SubmitSorted, then merges consecutive packets with transforms that
+        // share program, VAO, textures and uniform range into one multi draw indirect
+        // call, whatever their vertex ranges. Meant for meshes packed into one
+        // GeometryPool, where that collapses each sorted batch into a single call.
+        // Each draw's transform is written to a shader storage buffer bound at
+        // kDrawDataBinding, starting at the call's first draw:
+        //
+        //  #extension GL_ARB_shader_draw_parameters : require
+        //  layout (std430, binding = 2) readonly buffer DrawData { mat4 drawModel[]; };
+        //  ... drawModel[gl_DrawIDARB] ...
+        //
+        // Packets without a transform, or with their own instancing, are drawn one by
+        // one as in Submit. Requires InitIndirect.
+        void SubmitIndirect(const CommandBuffer& commands);
+
+        // Creates the persistently mapped instance buffer (GL 4.4), with room for
+        // maxInstancesPerFrame transforms in each of its regions
+        void InitInstancing(int maxInstancesPerFrame = 131072);
+        void ShutdownInstancing();
+
+        // Creates the persistently mapped indirect command and draw data buffers (GL 4.4
+        // and ARB_shader_draw_parameters in the shaders). Each multi draw call's draw
+        // data starts at the storage buffer offset alignment, maxCallsPerFrame sizes
+        // the padding that may need.
+        void InitIndirect(int maxDrawsPerFrame = 131072, int maxCallsPerFrame = 4096);
+        void ShutdownIndirect();
+
+        // Instance attributes are set up once per VAO name; call this when a VAO used
+        // with transforms is deleted, as GL may hand its name out again
+        void ForgetVao(unsigned int vao)
+        {
+            instancedVaos.erase(vao);
+        }
+
+        const RenderStats& GetStats() const
+        {
+            return stats;
+        }
+
+        void ResetStats()
+        {
+            stats = RenderStats();
+        }
+
 
     private:
+        // order holds packet indices, or is null for recording order
+        void SubmitPackets(const CommandBuffer& commands, const SortItem* order);
+        // Fills sortItems with the packets in ascending sort key order
+        void SortPackets(const CommandBuffer& commands);
+        void SubmitIndirectPackets(const CommandBuffer& commands, const SortItem* order);
+        // Binds what packet needs and bound does not hold yet, first rebinds everything
+        void BindState(const DrawPacket& packet, DrawPacket& bound, bool& first);
+        static bool CanInstance(const DrawPacket& batch, const DrawPacket& packet);
+        static bool CanMultiDraw(const DrawPacket& batch, const DrawPacket& packet);
+        void SetupInstancedVao(unsigned int vao);
+
         void UpdatePolygonMode()
         {
             nether::gl::polygonMode(face, mode);
@@ -125,6 +233,23 @@ namespace nether
         GLenum face = GL_FRONT_AND_BACK;
         GLenum mode = GL_FILL;
 
+        RenderStats stats;
+        std::vector<SortItem> sortItems;
+        std::vector<SortItem> sortScratch;
+
+        StreamingBuffer instanceBuffer;
+        // VAOs whose instance attributes point at instanceBuffer
+        std::unordered_set<unsigned int> instancedVaos;
+        bool warnedNoInstancing = false;
+
+        DrawIndirectBuffer indirectBuffer;
+        StreamingBuffer drawDataBuffer;
+        std::vector<DrawElementsIndirectCommand> elementCommands;
+        std::vector<DrawArraysIndirectCommand> arrayCommands;
+        bool warnedNoIndirect = false;
+
+        bool inFrame = false;
+
         // std::vector<Mesh> m_meshes;
         // std::vector<Sprite> m_sprites;
 
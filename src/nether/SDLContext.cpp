@@ -82,9 +82,12 @@ void GLAPIENTRY MessageCallback(GLenum source, GLenum type, GLuint id,
 
 namespace nether {
 
-	void SDLContext::Init(int width, int height) {
-		// code without checking for errors
-		SDL_Init(SDL_INIT_VIDEO);
+	bool SDLContext::Init(int width, int height) {
+		if (SDL_Init(SDL_INIT_VIDEO) != 0)
+		{
+			printf("SDL_Init failed: %s\n", SDL_GetError());
+			return false;
+		}
 
 		SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1);
 		SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 4);
@@ -97,24 +100,54 @@ namespace nether {
 			width, height,
 			SDL_WINDOW_OPENGL
 		);
+		if (window == nullptr)
+		{
+			printf("SDL_CreateWindow failed: %s\n", SDL_GetError());
+			Cleanup();
+			return false;
+		}
 
 		context = SDL_GL_CreateContext(window);
+		if (context == nullptr)
+		{
+			printf("SDL_GL_CreateContext failed: %s\n", SDL_GetError());
+			Cleanup();
+			return false;
+		}
 
 		int version = gladLoadGL((GLADloadfunc)SDL_GL_GetProcAddress);
+		if (version == 0)
+		{
+			printf("Failed to load GL\n");
+			Cleanup();
+			return false;
+		}
 		printf("GL %d.%d\n", GLAD_VERSION_MAJOR(version), GLAD_VERSION_MINOR(version));
 
+		nether::gl::initializeDirectGL();
+
 		// During init, enable debug output
 		glEnable(GL_DEBUG_OUTPUT);
 		glDebugMessageCallback(MessageCallback, 0);
+		return true;
 	}
 
 	void SDLContext::EndFrame() {
+		nether::gl::checkFrameErrors();
 		SDL_GL_SwapWindow(window);
 	}
 
 	void SDLContext::Cleanup() {
-		SDL_GL_DeleteContext(context);
-		SDL_DestroyWindow(window);
+		if (context != nullptr)
+		{
+			SDL_GL_DeleteContext(context);
+			context = nullptr;
+		}
+		if (window != nullptr)
+		{
+			SDL_DestroyWindow(window);
+			window = nullptr;
+		}
 		SDL_Quit();
 	}
 
@@ -3,19 +3,20 @@
 #ifndef AETHER_USE_QT
 #include <stdio.h>
 #include <SDL.h>
-#include "nethergl.h"
+#include "nether/NetherGL.h"
+#include "nether/GraphicsContext.h"
 
 namespace nether {
 
-	class SDLContext {
+	class SDLContext : public GraphicsContext {
 	public:
-		void Init(int width, int height);
-		void EndFrame();
-		void Cleanup();
+		bool Init(int width, int height) override;
+		void EndFrame() override;
+		void Cleanup() override;
 
 	private:
-		SDL_Window* window;
-		SDL_GLContext context;
+		SDL_Window* window = nullptr;
+		SDL_GLContext context = nullptr;
 	};
 
 }
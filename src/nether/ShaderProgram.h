@@ -5,9 +5,48 @@
 
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 namespace nether
 {
 
+    // Active uniform of a linked program, as reported by GL_ACTIVE_UNIFORMS
+    struct UniformInfo
+    {
+        std::string name;
+        int location = -1;
+        unsigned int type = 0;
+        int size = 0;
+
+        // Last uploaded value, stored in the program's shadow buffer
+        int shadowOffset = -1;
+        int shadowSize = 0;
+    };
+
+    struct UniformUploadStats
+    {
+        unsigned long long issued = 0;
+        unsigned long long skipped = 0;
+    };
+
+    // Uniform resolved once with ShaderProgram::GetUniformHandle and reused on every set.
+    // Handles are only valid for the program they were resolved from and until it is relinked.
+    struct UniformHandle
+    {
+        int index = -1;
+        int location = -1;
+
+        bool IsValid() const
+        {
+            return location != -1;
+        }
+    };
+
     class ShaderProgram
     {
     public:
@@ -51,21 +90,39 @@ namespace nether
             shaderProgram = nether::gl::createProgram();
             nether::gl::attachShader(shaderProgram, vertexShader.GetShaderObject());
             nether::gl::attachShader(shaderProgram, fragmentShader.GetShaderObject());
-            nether::gl::linkProgram(shaderProgram);
+            Link();
+        }
 
-            int success = 0;
-            nether::gl::getProgramiv(shaderProgram, GL_LINK_STATUS, &success);
-            if (!success) {
-                char infoLog[512];
-                nether::gl::getProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-                m_shaderProgramCompilationInfo.hasError = true;
-				m_shaderProgramCompilationInfo.infoText = "Shader program linking failed: " + std::string(infoLog);
-            }
-            else
-            {
-				m_shaderProgramCompilationInfo.hasError = false;
-				m_shaderProgramCompilationInfo.infoText = "Shader linking success!";
-            }
+        // Compute programs have a single stage (GL 4.3), run with dispatchCompute
+        void LoadCompute(const std::string& computeShaderFile)
+        {
+            m_shaderProgramCompilationInfo.fileLoad = true;
+
+            nether::Shader computeShader;
+            computeShader.Load(computeShaderFile, nether::ShaderType::ComputeShader);
+            m_computeShaderCompilationInfo = computeShader.GetCompilationInfo();
+
+            Load(computeShader);
+            computeShader.Clean();
+        }
+
+        void LoadComputeFromRawString(const std::string& computeShaderCode)
+        {
+            m_shaderProgramCompilationInfo.fileLoad = false;
+
+            nether::Shader computeShader;
+            computeShader.LoadCode(computeShaderCode, nether::ShaderType::ComputeShader);
+            m_computeShaderCompilationInfo = computeShader.GetCompilationInfo();
+
+            Load(computeShader);
+            computeShader.Clean();
+        }
+
+        void Load(Shader computeShader)
+        {
+            shaderProgram = nether::gl::createProgram();
+            nether::gl::attachShader(shaderProgram, computeShader.GetShaderObject());
+            Link();
         }
 
         void Use()
@@ -93,39 +150,159 @@ namespace nether
             nether::gl::deleteProgram(shaderProgram);
         }
 
+        // Resolves a uniform through the table built after linking. Names the driver did not
+        // report (e.g. "lights[3]") are queried once and then cached, misses included.
+        UniformHandle GetUniformHandle(const std::string& name)
+        {
+            auto it = m_uniformIndices.find(name);
+            if (it == m_uniformIndices.end())
+            {
+                UniformInfo info;
+                info.name = name;
+                info.location = nether::gl::getUniformLocation(shaderProgram, name.c_str());
+                it = m_uniformIndices.emplace(name, int(m_uniforms.size())).first;
+                m_uniforms.push_back(info);
+            }
+            return { it->second, m_uniforms[it->second].location };
+        }
+
+        // Connects the named uniform block to a buffer binding point, returns false if the
+        // program does not use the block
+        bool BindUniformBlock(const std::string& blockName, unsigned int bindingPoint)
+        {
+            unsigned int blockIndex = nether::gl::getUniformBlockIndex(shaderProgram, blockName.c_str());
+            if (blockIndex == GL_INVALID_INDEX)
+            {
+                return false;
+            }
+            nether::gl::uniformBlockBinding(shaderProgram, blockIndex, bindingPoint);
+            return true;
+        }
+
+        const std::vector<UniformInfo>& GetUniforms() const
+        {
+            return m_uniforms;
+        }
+
+        unsigned int GetProgram() const
+        {
+            return shaderProgram;
+        }
+
+        // Setters taking a handle compare against a CPU side copy of the last uploaded
+        // value and skip the upload when the bytes are unchanged (GL keeps uniform values
+        // per program, so the copy stays valid across Use/Unbind). The program must be
+        // in use for the upload, as with the plain uniform* calls.
+        void SetBoolUniform(UniformHandle handle, bool value)
+        {
+            SetIntUniform(handle, (int)value);
+        }
+
+        void SetIntUniform(UniformHandle handle, int value)
+        {
+            if (UpdateShadow(handle, &value, sizeof(value)))
+            {
+                nether::gl::uniform1i(handle.location, value);
+            }
+        }
+
+        void SetFloatUniform(UniformHandle handle, float value)
+        {
+            if (UpdateShadow(handle, &value, sizeof(value)))
+            {
+                nether::gl::uniform1f(handle.location, value);
+            }
+        }
+
+        void SetMat4Uniform(UniformHandle handle, const glm::mat4x4& mat)
+        {
+            if (UpdateShadow(handle, glm::value_ptr(mat), sizeof(float) * 16))
+            {
+                nether::gl::uniformMatrix4fv(handle.location, 1, GL_FALSE, glm::value_ptr(mat));
+            }
+        }
+
+        void SetVec2Uniform(UniformHandle handle, const glm::fvec2& vec)
+        {
+            const float values[2] = { vec.x, vec.y };
+            if (UpdateShadow(handle, values, sizeof(values)))
+            {
+                nether::gl::uniform2f(handle.location, vec.x, vec.y);
+            }
+        }
+
+        void SetVec3Uniform(UniformHandle handle, const glm::fvec3& vec)
+        {
+            const float values[3] = { vec.x, vec.y, vec.z };
+            if (UpdateShadow(handle, values, sizeof(values)))
+            {
+                nether::gl::uniform3f(handle.location, vec.x, vec.y, vec.z);
+            }
+        }
+
+        void SetVec4Uniform(UniformHandle handle, const glm::fvec4& vec)
+        {
+            const float values[4] = { vec.x, vec.y, vec.z, vec.a };
+            if (UpdateShadow(handle, values, sizeof(values)))
+            {
+                nether::gl::uniform4f(handle.location, vec.x, vec.y, vec.z, vec.a);
+            }
+        }
+
+        // Forgets the shadowed values, needed if uniforms were set behind the program's back
+        void InvalidateUniformShadow()
+        {
+            for (UniformInfo& info : m_uniforms)
+            {
+                info.shadowOffset = -1;
+                info.shadowSize = 0;
+            }
+            m_uniformShadow.clear();
+        }
+
+        const UniformUploadStats& GetUniformUploadStats() const
+        {
+            return m_uniformUploadStats;
+        }
+
+        void ResetUniformUploadStats()
+        {
+            m_uniformUploadStats = UniformUploadStats();
+        }
+
         void SetBoolUniform(const std::string& name, bool value)
         {
-            nether::gl::uniform1i(nether::gl::getUniformLocation(shaderProgram, name.c_str()), (int)value);
+            SetBoolUniform(GetUniformHandle(name), value);
         }
 
         void SetIntUniform(const std::string& name, int value)
         {
-            nether::gl::uniform1i(nether::gl::getUniformLocation(shaderProgram, name.c_str()), value);
+            SetIntUniform(GetUniformHandle(name), value);
         }
 
         void SetFloatUniform(const std::string& name, float value)
         {
-            nether::gl::uniform1f(nether::gl::getUniformLocation(shaderProgram, name.c_str()), value);
+            SetFloatUniform(GetUniformHandle(name), value);
         }
 
         void SetMat4Uniform(const std::string& name, const glm::mat4x4& mat)
         {
-            nether::gl::uniformMatrix4fv(nether::gl::getUniformLocation(shaderProgram, name.c_str()), 1, GL_FALSE, glm::value_ptr(mat));
+            SetMat4Uniform(GetUniformHandle(name), mat);
         }
 
         void SetVec2Uniform(const std::string& name, const glm::fvec2& vec)
         {
-            nether::gl::uniform2f(nether::gl::getUniformLocation(shaderProgram, name.c_str()), vec.x, vec.y);
+            SetVec2Uniform(GetUniformHandle(name), vec);
         }
 
         void SetVec3Uniform(const std::string& name, const glm::fvec3& vec)
         {
-            nether::gl::uniform3f(nether::gl::getUniformLocation(shaderProgram, name.c_str()), vec.x, vec.y, vec.z);
+            SetVec3Uniform(GetUniformHandle(name), vec);
         }
 
         void SetVec4Uniform(const std::string& name, const glm::fvec4& vec)
         {
-            nether::gl::uniform4f(nether::gl::getUniformLocation(shaderProgram, name.c_str()), vec.x, vec.y, vec.z, vec.a);
+            SetVec4Uniform(GetUniformHandle(name), vec);
         }
 
 		ShaderCompilationInfo GetVertexShaderCompilationInfo() const
@@ -138,15 +315,113 @@ namespace nether
             return m_fragmentShaderCompilationInfo;
         }
 
+        ShaderCompilationInfo GetComputeShaderCompilationInfo() const
+        {
+            return m_computeShaderCompilationInfo;
+        }
+
 		ShaderCompilationInfo GetShaderProgramCompilationInfo() const
 		{
 			return m_shaderProgramCompilationInfo;
 		}
 
     private:
-        unsigned int shaderProgram;
+        // Links the attached stages and rebuilds the uniform table
+        void Link()
+        {
+            nether::gl::linkProgram(shaderProgram);
+
+            int success = 0;
+            nether::gl::getProgramiv(shaderProgram, GL_LINK_STATUS, &success);
+            if (!success) {
+                char infoLog[512];
+                nether::gl::getProgramInfoLog(shaderProgram, 512, NULL, infoLog);
+                m_shaderProgramCompilationInfo.hasError = true;
+				m_shaderProgramCompilationInfo.infoText = "Shader program linking failed: " + std::string(infoLog);
+            }
+            else
+            {
+				m_shaderProgramCompilationInfo.hasError = false;
+				m_shaderProgramCompilationInfo.infoText = "Shader linking success!";
+            }
+
+            IntrospectUniforms();
+        }
+
+        // Returns true when the value differs from the shadowed one and has to be uploaded
+        bool UpdateShadow(UniformHandle handle, const void* data, int size)
+        {
+            if (handle.location == -1)
+            {
+                return false;
+            }
+
+            UniformInfo& info = m_uniforms[handle.index];
+            if (info.shadowSize != size)
+            {
+                info.shadowOffset = int(m_uniformShadow.size());
+                info.shadowSize = size;
+                m_uniformShadow.resize(m_uniformShadow.size() + size);
+            }
+            else if (std::memcmp(&m_uniformShadow[info.shadowOffset], data, size) == 0)
+            {
+                m_uniformUploadStats.skipped++;
+                return false;
+            }
+
+            std::memcpy(&m_uniformShadow[info.shadowOffset], data, size);
+            m_uniformUploadStats.issued++;
+            return true;
+        }
+
+        void IntrospectUniforms()
+        {
+            m_uniforms.clear();
+            m_uniformIndices.clear();
+            m_uniformShadow.clear();
+
+            int count = 0;
+            int maxNameLength = 0;
+            nether::gl::getProgramiv(shaderProgram, GL_ACTIVE_UNIFORMS, &count);
+            nether::gl::getProgramiv(shaderProgram, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+
+            std::vector<char> nameBuffer(std::max(maxNameLength, 1));
+            for (int i = 0; i < count; i++)
+            {
+                UniformInfo info;
+                int length = 0;
+                nether::gl::getActiveUniform(shaderProgram, i, int(nameBuffer.size()), &length, &info.size, &info.type, nameBuffer.data());
+                info.name.assign(nameBuffer.data(), length);
+                info.location = nether::gl::getUniformLocation(shaderProgram, info.name.c_str());
+
+                // Members of uniform blocks have no location
+                if (info.location == -1)
+                {
+                    continue;
+                }
+
+                int index = int(m_uniforms.size());
+                m_uniformIndices.emplace(info.name, index);
+
+                // Arrays are reported as "name[0]", make them reachable as "name" too
+                auto bracket = info.name.find('[');
+                if (bracket != std::string::npos)
+                {
+                    m_uniformIndices.emplace(info.name.substr(0, bracket), index);
+                }
+
+                m_uniforms.push_back(std::move(info));
+            }
+        }
+
+        unsigned int shaderProgram = 0;
+        std::vector<UniformInfo> m_uniforms;
+        std::unordered_map<std::string, int> m_uniformIndices;
+        std::vector<unsigned char> m_uniformShadow;
+        UniformUploadStats m_uniformUploadStats;
         ShaderCompilationInfo m_fragmentShaderCompilationInfo;
         ShaderCompilationInfo m_vertexShaderCompilationInfo;
+        ShaderCompilationInfo m_computeShaderCompilationInfo;
 		ShaderCompilationInfo m_shaderProgramCompilationInfo;
     };
 
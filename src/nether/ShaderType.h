@@ -1,13 +1,14 @@
 #pragma once
 
-#include "nethergl.h"
+#include "nether/NetherGL.h"
 
 namespace nether
 {
     enum ShaderType : GLenum
     {
         VertexShader = GL_VERTEX_SHADER,
-        FragmentShader = GL_FRAGMENT_SHADER
+        FragmentShader = GL_FRAGMENT_SHADER,
+        ComputeShader = GL_COMPUTE_SHADER
     };
 
 }
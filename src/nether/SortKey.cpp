@@ -0,0 +1,62 @@
+#include "SortKey.h"
+
+#include <utility>
+
+namespace nether {
+
+	void RadixSort(std::vector<SortItem>& items, std::vector<SortItem>& scratch)
+	{
+		const size_t count = items.size();
+		if (count < 2)
+		{
+			return;
+		}
+		scratch.resize(count);
+
+		// All eight histograms in one read of the keys
+		size_t histograms[8][256] = {};
+		for (const SortItem& item : items)
+		{
+			for (int pass = 0; pass < 8; pass++)
+			{
+				histograms[pass][(item.key >> (pass * 8)) & 0xFF]++;
+			}
+		}
+
+		SortItem* source = items.data();
+		SortItem* destination = scratch.data();
+
+		for (int pass = 0; pass < 8; pass++)
+		{
+			size_t* histogram = histograms[pass];
+			const int shift = pass * 8;
+
+			if (histogram[(source[0].key >> shift) & 0xFF] == count)
+			{
+				continue;
+			}
+
+			size_t offset = 0;
+			for (int bucket = 0; bucket < 256; bucket++)
+			{
+				const size_t bucketCount = histogram[bucket];
+				histogram[bucket] = offset;
+				offset += bucketCount;
+			}
+
+			for (size_t i = 0; i < count; i++)
+			{
+				const SortItem& item = source[i];
+				destination[histogram[(item.key >> shift) & 0xFF]++] = item;
+			}
+
+			std::swap(source, destination);
+		}
+
+		if (source != items.data())
+		{
+			items.swap(scratch);
+		}
+	}
+
+}
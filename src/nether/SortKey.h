@@ -0,0 +1,98 @@
+#pragma once
+
+#include "nether/CommandBuffer.h"
+
+namespace nether
+{
+
+    // Packs what a draw needs bound into a 64-bit key, most significant first, so
+    // that sorting packets by key groups draws sharing programs, then textures,
+    // then VAOs:
+    //
+    //  opaque       layer:4 | 0 | program:12 | material:16 | vao:12 | depth:19
+    //  translucent  layer:4 | 1 | ~depth:19 | program:12 | material:16 | vao:12
+    //
+    // Opaque draws are ordered front to back within a state group to help early z;
+    // translucent ones are ordered back to front first, as blending requires.
+    // GL names and material ids are truncated to their field width. That only
+    // weakens the grouping when names collide, the packet still binds real state.
+    struct SortKey
+    {
+        static constexpr int kLayerBits = 4;
+        static constexpr int kProgramBits = 12;
+        static constexpr int kMaterialBits = 16;
+        static constexpr int kVaoBits = 12;
+        static constexpr int kDepthBits = 19;
+
+        // depth is a normalized [0, 1] view depth, 0 at the camera
+        static unsigned long long Opaque(unsigned int layer, unsigned int program, unsigned int material,
+            unsigned int vao, float depth)
+        {
+            unsigned long long key = Field(layer, kLayerBits);
+            key = (key << 1) | 0;
+            key = (key << kProgramBits) | Field(program, kProgramBits);
+            key = (key << kMaterialBits) | Field(material, kMaterialBits);
+            key = (key << kVaoBits) | Field(vao, kVaoBits);
+            key = (key << kDepthBits) | QuantizeDepth(depth);
+            return key;
+        }
+
+        static unsigned long long Translucent(unsigned int layer, unsigned int program, unsigned int material,
+            unsigned int vao, float depth)
+        {
+            const unsigned long long depthMask = (1ull << kDepthBits) - 1;
+
+            unsigned long long key = Field(layer, kLayerBits);
+            key = (key << 1) | 1;
+            key = (key << kDepthBits) | (~QuantizeDepth(depth) & depthMask);
+            key = (key << kProgramBits) | Field(program, kProgramBits);
+            key = (key << kMaterialBits) | Field(material, kMaterialBits);
+            key = (key << kVaoBits) | Field(vao, kVaoBits);
+            return key;
+        }
+
+        // Key for a recorded packet, using its texture set as the material
+        static unsigned long long ForPacket(const DrawPacket& packet, unsigned int layer, bool translucent, float depth)
+        {
+            const unsigned int material = MaterialId(packet);
+            return translucent
+                ? Translucent(layer, packet.program, material, packet.vao, depth)
+                : Opaque(layer, packet.program, material, packet.vao, depth);
+        }
+
+        // FNV-1a over the bound texture names, folded to kMaterialBits
+        static unsigned int MaterialId(const DrawPacket& packet)
+        {
+            unsigned int hash = 2166136261u;
+            for (unsigned int texture : packet.textures)
+            {
+                hash = (hash ^ texture) * 16777619u;
+            }
+            return (hash >> kMaterialBits) ^ (hash & ((1u << kMaterialBits) - 1));
+        }
+
+        static unsigned long long QuantizeDepth(float depth)
+        {
+            const float clamped = depth < 0.f ? 0.f : (depth > 1.f ? 1.f : depth);
+            return (unsigned long long)(clamped * float((1u << kDepthBits) - 1));
+        }
+
+    private:
+        static unsigned long long Field(unsigned int value, int bits)
+        {
+            return value & ((1ull << bits) - 1);
+        }
+    };
+
+    struct SortItem
+    {
+        unsigned long long key = 0;
+        unsigned int index = 0;
+    };
+
+    // Stable LSD radix sort on the keys, one byte per pass. Passes where every key
+    // has the same byte are skipped, which is most of them for typical scenes.
+    // scratch is resized as needed and can be reused across calls.
+    void RadixSort(std::vector<SortItem>& items, std::vector<SortItem>& scratch);
+
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "nether/BufferObject.h"
+
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace nether
+{
+
+    // Shader storage buffer holding an array of T, bound to a fixed binding point.
+    // T must match the std430 layout of the shader's array element: scalars, vec2 and
+    // vec4 pack as in C++, but vec3 still aligns to 16 bytes and structs round up to
+    // their largest member, so pad explicitly and static_assert the size.
+    //
+    //  layout (std430, binding = 0) buffer Particles { Particle particles[]; };
+    //
+    //  particles.Generate(0, BufferUsage::DynamicCopy);
+    //  particles.Upload(initialParticles);
+    //  ... compute writes particles ...
+    //  std::vector<Particle> result = particles.Read(0, count);
+    //
+    // Requires GL 4.3.
+    template <typename T>
+    class StorageBuffer
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "storage buffer elements must be trivially copyable");
+
+    public:
+        void Generate(unsigned int bindingPoint, BufferUsage usage = BufferUsage::StaticDraw)
+        {
+            m_bindingPoint = bindingPoint;
+            m_buffer.Generate(BufferBindingTarget::ShaderStorageBuffer, usage);
+            m_count = 0;
+        }
+
+        void Delete()
+        {
+            m_buffer.Delete();
+            m_count = 0;
+        }
+
+        // Replaces the contents and binds the buffer to its binding point
+        void Upload(std::span<const T> items)
+        {
+            m_buffer.Bind();
+            m_buffer.UploadBufferData(items);
+            m_count = items.size();
+            Bind();
+        }
+
+        void Upload(const std::vector<T>& items)
+        {
+            Upload(std::span<const T>(items));
+        }
+
+        // Overwrites the elements starting at first, growing the buffer if needed
+        void Update(size_t first, std::span<const T> items)
+        {
+            m_buffer.Bind();
+            m_buffer.UpdateRange((long long)(first * sizeof(T)), items);
+            if (first + items.size() > m_count)
+            {
+                m_count = first + items.size();
+            }
+        }
+
+        // Makes room for count elements without uploading anything, e.g. for buffers
+        // only written by shaders. The contents are undefined until written.
+        void Resize(size_t count)
+        {
+            m_buffer.Bind();
+            m_buffer.Reserve((long long)(count * sizeof(T)));
+            m_count = count;
+            Bind();
+        }
+
+        // Copies elements back to the CPU, stalls until the GPU has written them.
+        // Shader writes need a GL_BUFFER_UPDATE_BARRIER_BIT barrier first.
+        std::vector<T> Read(size_t first, size_t count)
+        {
+            std::vector<T> items(count);
+            m_buffer.Bind();
+            nether::gl::getBufferSubData(GL_SHADER_STORAGE_BUFFER, (long long)(first * sizeof(T)), (long long)(count * sizeof(T)), items.data());
+            return items;
+        }
+
+        // Rebinds the buffer to its binding point, only needed if something else used it
+        void Bind()
+        {
+            m_buffer.BindBase(m_bindingPoint);
+        }
+
+        size_t GetCount() const
+        {
+            return m_count;
+        }
+
+        unsigned int GetBindingPoint() const
+        {
+            return m_bindingPoint;
+        }
+
+        unsigned int GetBufferObject() const
+        {
+            return m_buffer.GetBufferObject();
+        }
+
+        BufferObject& GetBuffer()
+        {
+            return m_buffer;
+        }
+
+    private:
+        BufferObject m_buffer;
+        size_t m_count = 0;
+        unsigned int m_bindingPoint = 0;
+    };
+
+}
@@ -0,0 +1,136 @@
+#include "StreamingBuffer.h"
+
+namespace nether {
+
+	namespace {
+
+		long long AlignUp(long long value, long long alignment)
+		{
+			return (value + alignment - 1) / alignment * alignment;
+		}
+
+	}
+
+	void StreamingBuffer::Generate(BufferBindingTarget target, long long regionSize)
+	{
+		m_target = target;
+
+		int minAlignment = 1;
+		if (target == BufferBindingTarget::UniformBuffer)
+		{
+			nether::gl::getIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &minAlignment);
+		}
+		else if (target == BufferBindingTarget::ShaderStorageBuffer)
+		{
+			nether::gl::getIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &minAlignment);
+		}
+		m_minAlignment = minAlignment > 0 ? minAlignment : 1;
+		m_regionSize = AlignUp(regionSize, m_minAlignment);
+
+		const long long totalSize = m_regionSize * kRegionCount;
+		const unsigned int flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+		nether::gl::genBuffers(1, &m_buffer);
+		Bind();
+		nether::gl::bufferStorage(GLenum(m_target), totalSize, nullptr, flags);
+		m_mapped = static_cast<unsigned char*>(nether::gl::mapBufferRange(GLenum(m_target), 0, totalSize, flags));
+
+		m_region = 0;
+		m_head = 0;
+	}
+
+	void StreamingBuffer::Delete()
+	{
+		for (void*& fence : m_fences)
+		{
+			if (fence != nullptr)
+			{
+				nether::gl::deleteSync(fence);
+				fence = nullptr;
+			}
+		}
+
+		if (m_buffer != 0)
+		{
+			Bind();
+			nether::gl::unmapBuffer(GLenum(m_target));
+			nether::gl::deleteBuffers(1, &m_buffer);
+		}
+
+		m_buffer = 0;
+		m_mapped = nullptr;
+	}
+
+	void StreamingBuffer::BeginFrame()
+	{
+		void*& fence = m_fences[m_region];
+		if (fence != nullptr)
+		{
+			unsigned int result = nether::gl::clientWaitSync(fence, 0, 0);
+			if (result != GL_ALREADY_SIGNALED && result != GL_CONDITION_SATISFIED)
+			{
+				m_stats.fenceWaits++;
+				const unsigned long long timeoutNs = 1000000;
+				do
+				{
+					result = nether::gl::clientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, timeoutNs);
+				} while (result == GL_TIMEOUT_EXPIRED);
+			}
+			nether::gl::deleteSync(fence);
+			fence = nullptr;
+		}
+		m_head = 0;
+	}
+
+	StreamingAllocation StreamingBuffer::Allocate(long long size, long long alignment)
+	{
+		StreamingAllocation allocation;
+		if (m_mapped == nullptr)
+		{
+			m_stats.failedAllocations++;
+			return allocation;
+		}
+
+		// The offset is aligned within the whole buffer, region starts are only
+		// aligned to the minimum alignment
+		const long long regionStart = m_regionSize * m_region;
+		const long long offset = AlignUp(regionStart + m_head, alignment > m_minAlignment ? alignment : m_minAlignment);
+		if (offset - regionStart + size > m_regionSize)
+		{
+			m_stats.failedAllocations++;
+			return allocation;
+		}
+
+		m_head = offset - regionStart + size;
+		m_stats.allocations++;
+
+		allocation.offset = offset;
+		allocation.data = m_mapped + allocation.offset;
+		allocation.size = size;
+		return allocation;
+	}
+
+	void StreamingBuffer::EndFrame()
+	{
+		// Without a BeginFrame since the region's last use its fence is still there
+		void*& fence = m_fences[m_region];
+		if (fence != nullptr)
+		{
+			nether::gl::deleteSync(fence);
+		}
+		fence = nether::gl::fenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		m_region = (m_region + 1) % kRegionCount;
+		m_head = 0;
+	}
+
+	void StreamingBuffer::Bind()
+	{
+		nether::gl::bindBuffer(GLenum(m_target), m_buffer);
+	}
+
+	void StreamingBuffer::BindRange(unsigned int index, const StreamingAllocation& allocation)
+	{
+		nether::gl::bindBufferRange(GLenum(m_target), index, m_buffer, allocation.offset, allocation.size);
+	}
+
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "nether/BufferBindingTarget.h"
+#include "nether/NetherGL.h"
+
+namespace nether
+{
+
+    // Region of a StreamingBuffer handed out for this frame. data is a write-only
+    // pointer into persistently mapped memory, offset is where it lives in the
+    // GL buffer (for bindBufferRange, vertex attrib offsets, base vertex...).
+    struct StreamingAllocation
+    {
+        void* data = nullptr;
+        long long offset = 0;
+        long long size = 0;
+
+        bool IsValid() const
+        {
+            return data != nullptr;
+        }
+    };
+
+    struct StreamingBufferStats
+    {
+        unsigned long long allocations = 0;
+        unsigned long long failedAllocations = 0;
+        unsigned long long fenceWaits = 0;
+    };
+
+    // Persistently mapped buffer for data rewritten every frame (dynamic geometry,
+    // per draw uniforms). Storage is allocated once with glBufferStorage and split
+    // into kRegionCount regions used round robin, one per frame in flight. Each
+    // region is fenced when its frame ends and the fence is only waited on when the
+    // region comes around again, so with triple buffering the CPU normally never
+    // waits and nothing is ever reallocated or orphaned.
+    //
+    //  buffer.BeginFrame();
+    //  auto alloc = buffer.Allocate(sizeof(PerDraw), alignment);
+    //  memcpy(alloc.data, &perDraw, sizeof(PerDraw));
+    //  buffer.BindRange(0, alloc);
+    //  ... draw ...
+    //  buffer.EndFrame();
+    //
+    // Requires GL 4.4 (or ARB_buffer_storage).
+    class StreamingBuffer
+    {
+    public:
+        static constexpr int kRegionCount = 3;
+
+        StreamingBuffer() = default;
+        StreamingBuffer(const StreamingBuffer&) = delete;
+        StreamingBuffer& operator=(const StreamingBuffer&) = delete;
+
+        // regionSize is the most that can be allocated per frame
+        void Generate(BufferBindingTarget target, long long regionSize);
+        void Delete();
+
+        // Waits for the GPU to be done with the region about to be reused
+        void BeginFrame();
+
+        // Sub-allocates size bytes from the current region. Offsets are aligned to
+        // alignment and to the target's minimum offset alignment. Returns an invalid
+        // allocation when the region is full.
+        StreamingAllocation Allocate(long long size, long long alignment = 16);
+
+        // Fences the current region and moves on to the next one
+        void EndFrame();
+
+        void Bind();
+        void BindRange(unsigned int index, const StreamingAllocation& allocation);
+
+        unsigned int GetBufferObject() const
+        {
+            return m_buffer;
+        }
+
+        long long GetRegionSize() const
+        {
+            return m_regionSize;
+        }
+
+        long long GetUsedBytes() const
+        {
+            return m_head;
+        }
+
+        const StreamingBufferStats& GetStats() const
+        {
+            return m_stats;
+        }
+
+    private:
+        BufferBindingTarget m_target = BufferBindingTarget::ArrayBuffer;
+        unsigned int m_buffer = 0;
+        unsigned char* m_mapped = nullptr;
+        long long m_regionSize = 0;
+        long long m_minAlignment = 1;
+        long long m_head = 0;
+        int m_region = 0;
+        void* m_fences[kRegionCount] = {};
+        StreamingBufferStats m_stats;
+    };
+
+}
@@ -1,6 +1,10 @@
 #ifndef AETHER_USE_QT
 #include "TestApp.h"
 
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
 namespace nether
 {
 
@@ -28,68 +32,222 @@ namespace nether
 
 	void TestApp::Run(int screenWidth /*= 800*/, int screenHeight /*= 600*/)
 	{
-		m_ctx.Init(screenWidth, screenHeight);
+		const char* headlessFrames = std::getenv("NETHER_HEADLESS_FRAMES");
+		if (headlessFrames != nullptr && std::atoi(headlessFrames) > 0)
+		{
+			RunHeadless(std::atoi(headlessFrames), screenWidth, screenHeight);
+			return;
+		}
+
+		RunWindowed(screenWidth, screenHeight);
+	}
+
+	bool TestApp::RunHeadless(int frameCount, int screenWidth /*= 800*/, int screenHeight /*= 600*/)
+	{
+		if (frameCount <= 0)
+		{
+			return false;
+		}
+
+		auto headless = std::make_unique<nether::HeadlessContext>();
+		// The frame time statistics below should include the GPU work
+		headless->SetFinishEachFrame(true);
+		m_ctx = std::move(headless);
+		if (!m_ctx->Init(screenWidth, screenHeight))
+		{
+			m_ctx.reset();
+			return false;
+		}
+		g_gpuProfiler.Init();
 
 		Init();
 
-		int exit = 0;
-		uint64_t ticks = SDL_GetTicks();
-
-		while (!exit) {
-			SDL_Event event;
-			while (SDL_PollEvent(&event)) {
-				switch (event.type) {
-				case SDL_QUIT:
-					exit = 1;
-					break;
-				case SDL_KEYUP:
-					if (event.key.keysym.sym == SDLK_ESCAPE) {
-						exit = 1;
-					}
-					if (event.key.keysym.sym == SDLK_p) {
-						GetRenderer().SetWireframeMode();
-					}
-					if (event.key.keysym.sym == SDLK_o) {
-						GetRenderer().SetFillMode();
-					}
-					if (event.key.keysym.sym == SDLK_i) {
-						GetRenderer().SetFront();
-					}
-					if (event.key.keysym.sym == SDLK_u) {
-						GetRenderer().SetBack();
-					}
-					if (event.key.keysym.sym == SDLK_y) {
-						GetRenderer().SetFrontBack();
-					}
-					OnKeyUp(event);
-					break;
-				case SDL_MOUSEMOTION:
+		StartTrace();
+
+		// Fixed step so runs are reproducible regardless of how long frames take
+		const float delta = 1000.0f / 60.0f;
+		std::vector<double> frameTimes;
+		frameTimes.reserve(frameCount);
+
+		for (int frame = 0; frame < frameCount; ++frame) {
+			long long start = CpuProfiler::Now();
+			{
+				NETHER_CPU_SCOPE("Frame");
+
+				g_gpuProfiler.BeginFrame();
+				m_renderer.BeginFrame();
 				{
-					float mx = float(event.motion.x);
-					float my = float(event.motion.y);
-					MouseMoved(mx, my);
+					NETHER_CPU_SCOPE("Step");
+					NETHER_GPU_SCOPE("Step");
+					Step(delta);
 				}
-				break;
-				default:
-					break;
+				m_renderer.EndFrame();
+				g_gpuProfiler.EndFrame();
+
+				{
+					NETHER_CPU_SCOPE("Swap");
+					m_ctx->EndFrame();
 				}
 			}
+			g_cpuProfiler.EndFrame();
+
+			frameTimes.push_back(double(CpuProfiler::Now() - start) * 1e-6);
+		}
+
+		FinishTrace();
 
-			auto currentTicks = SDL_GetTicks();
-			float delta = currentTicks - ticks;
-			Step(float(delta));
-			ticks = currentTicks;
+		std::vector<GpuScopeStats> gpuStats = g_gpuProfiler.GetScopeStats();
 
-			m_ctx.EndFrame();
+		Cleanup();
+		g_gpuProfiler.Shutdown();
+		m_ctx->Cleanup();
+		m_ctx.reset();
+
+		double total = 0.0;
+		for (double time : frameTimes) {
+			total += time;
+		}
+		std::sort(frameTimes.begin(), frameTimes.end());
+		size_t p99 = std::min(frameTimes.size() - 1, frameTimes.size() * 99 / 100);
+		printf("%d headless frames: avg %.3f ms, min %.3f ms, p50 %.3f ms, p99 %.3f ms, max %.3f ms\n",
+			frameCount, total / frameCount, frameTimes.front(), frameTimes[frameTimes.size() / 2],
+			frameTimes[p99], frameTimes.back());
+		for (const GpuScopeStats& scope : gpuStats) {
+			printf("  gpu %-20s avg %.3f ms, min %.3f ms, max %.3f ms (%d frames)\n",
+				scope.name, scope.avgMs, scope.minMs, scope.maxMs, scope.samples);
 		}
+		return true;
+	}
+
+	void TestApp::RunWindowed(int screenWidth, int screenHeight)
+	{
+		m_ctx = std::make_unique<nether::SDLContext>();
+		if (!m_ctx->Init(screenWidth, screenHeight))
+		{
+			m_ctx.reset();
+			return;
+		}
+		g_gpuProfiler.Init();
+
+		Init();
+
+		StartTrace();
+
+		bool running = true;
+		long long lastFrame = CpuProfiler::Now();
+
+		while (running) {
+			{
+				NETHER_CPU_SCOPE("Frame");
+				{
+					NETHER_CPU_SCOPE("Events");
+					running = PollEvents();
+				}
+
+				long long now = CpuProfiler::Now();
+				float delta = float(now - lastFrame) * 1e-6f;
+				lastFrame = now;
+
+				g_gpuProfiler.BeginFrame();
+				m_renderer.BeginFrame();
+				{
+					NETHER_CPU_SCOPE("Step");
+					NETHER_GPU_SCOPE("Step");
+					Step(delta);
+				}
+				m_renderer.EndFrame();
+				g_gpuProfiler.EndFrame();
+
+				{
+					NETHER_CPU_SCOPE("Swap");
+					m_ctx->EndFrame();
+				}
+			}
+			g_cpuProfiler.EndFrame();
+		}
+
+		FinishTrace();
 
 		Cleanup();
-		m_ctx.Cleanup();
+		g_gpuProfiler.Shutdown();
+		m_ctx->Cleanup();
+		m_ctx.reset();
+	}
+
+	bool TestApp::PollEvents()
+	{
+		bool running = true;
+		SDL_Event event;
+		while (SDL_PollEvent(&event)) {
+			switch (event.type) {
+			case SDL_QUIT:
+				running = false;
+				break;
+			case SDL_KEYUP:
+				if (event.key.keysym.sym == SDLK_ESCAPE) {
+					running = false;
+				}
+				if (event.key.keysym.sym == SDLK_p) {
+					GetRenderer().SetWireframeMode();
+				}
+				if (event.key.keysym.sym == SDLK_o) {
+					GetRenderer().SetFillMode();
+				}
+				if (event.key.keysym.sym == SDLK_i) {
+					GetRenderer().SetFront();
+				}
+				if (event.key.keysym.sym == SDLK_u) {
+					GetRenderer().SetBack();
+				}
+				if (event.key.keysym.sym == SDLK_y) {
+					GetRenderer().SetFrontBack();
+				}
+				OnKeyUp(event);
+				break;
+			case SDL_MOUSEMOTION:
+			{
+				float mx = float(event.motion.x);
+				float my = float(event.motion.y);
+				MouseMoved(mx, my);
+			}
+			break;
+			default:
+				break;
+			}
+		}
+		return running;
+	}
+
+	void TestApp::StartTrace()
+	{
+		const char* tracePath = std::getenv("NETHER_TRACE");
+		m_tracePath = tracePath != nullptr ? tracePath : "";
+
+		g_cpuProfiler.SetCapture(!m_tracePath.empty());
+		g_gpuProfiler.SetCapture(!m_tracePath.empty());
+	}
+
+	void TestApp::FinishTrace()
+	{
+		if (m_tracePath.empty())
+		{
+			return;
+		}
+
+		// Frames still in flight on the GPU are not resolved and are left out
+		g_cpuProfiler.WriteChromeTrace(m_tracePath, g_gpuProfiler);
+		g_cpuProfiler.SetCapture(false);
+		g_gpuProfiler.SetCapture(false);
+	}
+
+	nether::GraphicsContext& TestApp::GetCtx()
+	{
+		return *m_ctx;
 	}
 
-	nether::SDLContext& TestApp::GetCtx()
+	bool TestApp::IsHeadless() const
 	{
-		return m_ctx;
+		return m_ctx != nullptr && m_ctx->IsHeadless();
 	}
 
 	nether::Renderer& TestApp::GetRenderer()
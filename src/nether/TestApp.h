@@ -1,9 +1,15 @@
 #pragma once
 
 #ifndef AETHER_USE_QT
+#include "nether/CpuProfiler.h"
+#include "nether/GpuProfiler.h"
 #include "nether/SDLContext.h"
+#include "nether/HeadlessContext.h"
 #include "nether/Renderer.h"
 
+#include <memory>
+#include <string>
+
 namespace nether
 {
 
@@ -22,19 +28,37 @@ namespace nether
 
         virtual void MouseMoved(float mousePosX, float mousePosY);
 
+        // Opens an SDL window and runs until it is closed. When the NETHER_HEADLESS_FRAMES
+        // environment variable holds a frame count, runs headless for that many frames instead.
+        // When NETHER_TRACE names a file, CPU and GPU scopes are written there as a Chrome trace.
         void Run(int screenWidth = 800, int screenHeight = 600);
 
+        // Renders a fixed number of frames into an offscreen EGL context with a fixed
+        // 60 Hz step, then prints frame timings. Returns false if no context could be created.
+        bool RunHeadless(int frameCount, int screenWidth = 800, int screenHeight = 600);
+
     protected:
-        nether::SDLContext& GetCtx();
+        nether::GraphicsContext& GetCtx();
+
+        bool IsHeadless() const;
 
         nether::Renderer& GetRenderer();
 
 
     private:
-        nether::SDLContext m_ctx;
+        void RunWindowed(int screenWidth, int screenHeight);
+
+        // Returns false when the window was closed
+        bool PollEvents();
+
+        void StartTrace();
+        void FinishTrace();
+
+        std::unique_ptr<nether::GraphicsContext> m_ctx;
         nether::Renderer m_renderer;
         int m_windowWidth = 0;
         int m_windowHeight = 0;
+        std::string m_tracePath;
 
 
     };
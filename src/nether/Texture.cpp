@@ -2,32 +2,55 @@
 #include <stb_image.h>
 
 #include "Texture.h"
+#include "CookedTexture.h"
 #include "GLType.h"
+#include "TextureContainer.h"
 #include <iostream>
+#include <vector>
 
 namespace nether {
 
-	int Texture::LoadFromFile(const std::string& filePath) {
-		int numChannels;
-		unsigned char* data = stbi_load(filePath.c_str(), &m_width, &m_height, &numChannels, 0);
+	namespace {
 
-		TextureFormat textureFormat = TextureFormat::RGB8;
-		if(numChannels == 4)
+		int GetCompressedBlockBytes(unsigned int internalFormat)
 		{
-			textureFormat = TextureFormat::RGBA8;
+			for (TextureFormat format : { TextureFormat::BC1, TextureFormat::BC3, TextureFormat::BC5, TextureFormat::BC7 })
+			{
+				if (TextureFormatUtils::GetGLInternalFormat(format) == internalFormat)
+				{
+					return TextureFormatUtils::GetBlockBytes(format);
+				}
+			}
+			return 0;
 		}
-		else if(numChannels == 3)
-		{
-			textureFormat = TextureFormat::RGB8;
+
+	}
+
+	int Texture::LoadFromFile(const std::string& filePath) {
+		if (CookedTexture::IsCookedFile(filePath)) {
+			CookedTexture cooked;
+			if (!cooked.Open(filePath)) {
+				return -1;
+			}
+			Create(cooked);
+			return 0;
 		}
-		else
-		{
-			assert(false);
+
+		if (TextureContainer::IsContainerFile(filePath)) {
+			TextureContainer container;
+			if (!TextureContainer::Load(filePath, container)) {
+				return -1;
+			}
+			Create(container);
+			return 0;
 		}
 
+		TextureFormat textureFormat = TextureFormat::RGB8;
+		unsigned char* data = DecodeFile(filePath, m_width, m_height, textureFormat);
+
 		if (data != nullptr) {
 			Create(m_width, m_height, data, textureFormat, true);
-			stbi_image_free(data);
+			FreeDecoded(data);
 		}
 		else {
 			std::cout << "Failed to load texture.";
@@ -37,6 +60,41 @@ namespace nether {
 		return 0;
 	}
 
+	unsigned char* Texture::DecodeFile(const std::string& filePath, int& width, int& height, TextureFormat& format)
+	{
+		int numChannels = 0;
+		unsigned char* data = stbi_load(filePath.c_str(), &width, &height, &numChannels, 0);
+
+		// Grey and grey + alpha images are expanded rather than uploaded as R8/RG8,
+		// which would sample as red and red + green
+		if (data != nullptr && numChannels != 3 && numChannels != 4)
+		{
+			stbi_image_free(data);
+			data = stbi_load(filePath.c_str(), &width, &height, &numChannels, 4);
+			numChannels = 4;
+		}
+
+		format = numChannels == 4 ? TextureFormat::RGBA8 : TextureFormat::RGB8;
+		return data;
+	}
+
+	void Texture::FreeDecoded(unsigned char* pixels)
+	{
+		stbi_image_free(pixels);
+	}
+
+
+	int Texture::GetMipLevelCount(int width, int height)
+	{
+		int size = width > height ? width : height;
+		int levels = 1;
+		while (size > 1)
+		{
+			size >>= 1;
+			levels++;
+		}
+		return levels;
+	}
 
 	void Texture::Create(int width, int height, TextureFormat textureFormat, bool createMipMaps)
 	{
@@ -45,31 +103,78 @@ namespace nether {
 
 	void Texture::Create(int width, int height, unsigned char* pixels, TextureFormat format, bool createMipMaps)
 	{
-		nether::gl::genTextures(1, &m_texture);
-		nether::gl::bindTexture(GL_TEXTURE_2D, m_texture);
+		const bool generateMips = createMipMaps && !TextureFormatUtils::IsCompressed(format);
+		Create(width, height, generateMips ? GetMipLevelCount(width, height) : 1, format);
+		if (pixels != nullptr)
+		{
+			Upload(0, pixels);
+			if (generateMips)
+			{
+				nether::gl::generateMipmap(GL_TEXTURE_2D);
+			}
+		}
+	}
 
-		nether::gl::texParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, static_cast<GLint>(m_xWrap));
-		nether::gl::texParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, static_cast<GLint>(m_yWrap));
-		nether::gl::texParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, static_cast<GLint>(m_minFilter));
-		nether::gl::texParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, static_cast<GLint>(m_magFilter));
+	void Texture::Create(int width, int height, int levels, TextureFormat format)
+	{
+		CreateStorage(width, height, levels,
+					  TextureFormatUtils::GetGLInternalFormat(format),
+					  TextureFormatUtils::GetGLFormat(format),
+					  TextureFormatUtils::GetGLType(format));
+	}
 
-		nether::gl::texImage2D(GL_TEXTURE_2D,
-							   0,
-							   TextureFormatUtils::GetGLInternalFormat(format),
-							   width, height,
-							   0,
-							   TextureFormatUtils::GetGLFormat(format),
-							   TextureFormatUtils::GetGLType(format),
-							   pixels);
+	void Texture::Create(const TextureDesc* levels, int levelCount)
+	{
+		Create(levels[0].width, levels[0].height, levelCount, levels[0].format);
+		for (int level = 0; level < levelCount; level++)
+		{
+			Upload(level, 0, 0, levels[level].width, levels[level].height, levels[level].pixels);
+		}
+	}
+
+	void Texture::Create(const TextureContainer& container)
+	{
+		std::vector<TextureDesc> levels;
+		for (const TextureLevelData& level : container.levels)
+		{
+			// Upload only reads the pixels
+			unsigned char* pixels = const_cast<unsigned char*>(container.data.data()) + level.offset;
+			levels.push_back({ level.width, level.height, pixels, container.format });
+		}
+		Create(levels.data(), int(levels.size()));
+	}
 
-		if(createMipMaps)
+	void Texture::Create(const CookedTexture& cooked)
+	{
+		Create(cooked.GetWidth(), cooked.GetHeight(), cooked.GetLevelCount(), cooked.GetFormat());
+		for (int level = 0; level < cooked.GetLevelCount(); level++)
 		{
-			nether::gl::generateMipmap(GL_TEXTURE_2D);
+			const CookedTextureLevel& data = cooked.GetLevel(level);
+			Upload(level, 0, 0, int(data.width), int(data.height), cooked.GetLevelData(level));
 		}
 	}
 
 	void Texture::Create(int width, int height, TextureFormat internalFormat, TextureFormat format, GLType type, bool createMipMaps)
 	{
+		CreateStorage(width, height, createMipMaps ? GetMipLevelCount(width, height) : 1,
+					  TextureFormatUtils::GetGLInternalFormat(internalFormat),
+					  TextureFormatUtils::GetGLFormat(format),
+					  static_cast<unsigned int>(type));
+	}
+
+	void Texture::Create(int width, int height, unsigned int internalFormat, unsigned int format, unsigned int type, bool createMipMaps)
+	{
+		CreateStorage(width, height, createMipMaps ? GetMipLevelCount(width, height) : 1, internalFormat, format, type);
+	}
+
+	void Texture::CreateStorage(int width, int height, int levels, unsigned int internalFormat, unsigned int format, unsigned int type)
+	{
+		// Immutable storage can't be respecified, a new size or format needs a new name
+		if (m_texture != 0)
+		{
+			Delete();
+		}
+
 		nether::gl::genTextures(1, &m_texture);
 		nether::gl::bindTexture(GL_TEXTURE_2D, m_texture);
 
@@ -78,43 +183,41 @@ namespace nether {
 		nether::gl::texParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, static_cast<GLint>(m_minFilter));
 		nether::gl::texParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, static_cast<GLint>(m_magFilter));
 
-		nether::gl::texImage2D(GL_TEXTURE_2D,
-							   0,
-							   TextureFormatUtils::GetGLInternalFormat(format),
-							   width, height,
-							   0,
-							   TextureFormatUtils::GetGLFormat(format),
-							   TextureFormatUtils::GetGLType(format),
-							   nullptr);
-
-		if(createMipMaps)
-		{
-			nether::gl::generateMipmap(GL_TEXTURE_2D);
-		}
+		nether::gl::texStorage2D(GL_TEXTURE_2D, levels, internalFormat, width, height);
 
+		m_width = width;
+		m_height = height;
+		m_levels = levels;
+		m_internalFormat = internalFormat;
+		m_pixelFormat = format;
+		m_pixelType = type;
+		m_blockBytes = GetCompressedBlockBytes(internalFormat);
 	}
 
+	void Texture::Upload(int level, const void* pixels)
+	{
+		const int width = m_width >> level;
+		const int height = m_height >> level;
+		Upload(level, 0, 0, width > 0 ? width : 1, height > 0 ? height : 1, pixels);
+	}
 
-	void Texture::Create(int width, int height, unsigned int internalFormat, unsigned int format, unsigned int type, bool createMipMaps)
+	void Texture::Upload(int level, int x, int y, int width, int height, const void* pixels)
 	{
-		nether::gl::genTextures(1, &m_texture);
 		nether::gl::bindTexture(GL_TEXTURE_2D, m_texture);
-		nether::gl::texParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, static_cast<GLint>(m_xWrap));
-		nether::gl::texParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, static_cast<GLint>(m_yWrap));
-		nether::gl::texParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, static_cast<GLint>(m_minFilter));
-		nether::gl::texParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, static_cast<GLint>(m_magFilter));
-		nether::gl::texImage2D(GL_TEXTURE_2D,
-							   0,
-							   internalFormat,
-							   width, height,
-							   0,
-							   format,
-							   type,
-							   nullptr);
-		if(createMipMaps)
+		if (m_blockBytes != 0)
 		{
-			nether::gl::generateMipmap(GL_TEXTURE_2D);
+			// Offsets and sizes are in pixels but must cover whole blocks, except at the
+			// right and bottom edges
+			const int imageSize = ((width + 3) / 4) * ((height + 3) / 4) * m_blockBytes;
+			nether::gl::compressedTexSubImage2D(GL_TEXTURE_2D, level, x, y, width, height, m_internalFormat, imageSize, pixels);
+			return;
 		}
+
+		// Rows are tightly packed, RGB8 rows are rarely a multiple of 4 bytes. Left set,
+		// like the binding: the state cache skips it on the next upload, and whoever
+		// needs another alignment sets it through pixelStorei.
+		nether::gl::pixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		nether::gl::texSubImage2D(GL_TEXTURE_2D, level, x, y, width, height, m_pixelFormat, m_pixelType, pixels);
 	}
 
 	void Texture::Bind(TextureUnit texUnit)
@@ -128,6 +231,19 @@ namespace nether {
 		nether::gl::bindTexture(GL_TEXTURE_2D, m_texture);
 	}
 
+	void Texture::GenerateMipmaps()
+	{
+		nether::gl::bindTexture(GL_TEXTURE_2D, m_texture);
+		nether::gl::generateMipmap(GL_TEXTURE_2D);
+	}
+
+	void Texture::Delete()
+	{
+		nether::gl::deleteTextures(1, &m_texture);
+		m_texture = 0;
+		m_levels = 0;
+	}
+
 	void Texture::SetXWrap(TextureWrap xWrap) {
 		m_xWrap = xWrap;
 	}
@@ -11,6 +11,10 @@
 
 namespace nether {
 
+	class CookedTexture;
+	struct TextureContainer;
+
+	// One level of a precomputed mip chain, see Texture::Create(const TextureDesc*, int)
 	struct TextureDesc {
 		int width;
 		int height;
@@ -18,15 +22,55 @@ namespace nether {
 		TextureFormat format;
 	};
 
+	// Textures use immutable storage (texStorage2D): every Create allocates all of its
+	// levels up front, with sized internal formats, and replaces any previous storage.
+	// Levels are then filled with Upload, from tightly packed rows or whole compressed
+	// blocks, or from level 0 with GenerateMipmaps (not for compressed formats).
+
 	class Texture {
 	public:
+		// Decodes PNG, JPG... with stb_image, .dds and .ktx2 files are uploaded as stored,
+		// see TextureContainer, and .ntex files straight from a mapping, see CookedTexture
 		int LoadFromFile(const std::string& filePath);
+
+		// Decodes an image file to RGB8 or RGBA8 pixels without touching GL, so it can
+		// run on any thread. Returns null on failure; free the pixels with FreeDecoded.
+		static unsigned char* DecodeFile(const std::string& filePath, int& width, int& height, TextureFormat& format);
+		static void FreeDecoded(unsigned char* pixels);
+
+		// GL_MAX_TEXTURE_SIZE every GL 4.1+ context supports. Files are checked against it
+		// rather than the context's value since they may be loaded on another thread.
+		static constexpr int kMaxSize = 16384;
+
+		// Number of levels in a full mip chain down to 1x1
+		static int GetMipLevelCount(int width, int height);
+
+		// With createMipMaps the full chain is allocated and, when pixels are given,
+		// generated from them. Compressed formats get a single level, they can't be
+		// generated.
 		void Create(int width, int height, unsigned char* pixels, TextureFormat format, bool createMipMaps);
+		void Create(int width, int height, TextureFormat textureFormat, bool createMipMaps);
+		// Allocates levels levels without uploading anything
+		void Create(int width, int height, int levels, TextureFormat format);
+		// Uploads a precomputed mip chain, levels[0] being the full size image
+		void Create(const TextureDesc* levels, int levelCount);
+		void Create(const TextureContainer& container);
+		void Create(const CookedTexture& cooked);
+		// format and type describe the pixels later passed to Upload; internalFormat must
+		// be sized (GL_RGBA8, not GL_RGBA)
 		void Create(int width, int height, TextureFormat internalFormat, TextureFormat format, GLType type, bool createMipMaps);
 		void Create(int width, int height, unsigned int internalFormat, unsigned int format, unsigned int type, bool createMipMaps);
-		void Create(int width, int height, TextureFormat textureFormat, bool createMipMaps);
+
+		// Replaces a whole level, or a region of it, with pixels in the format given at
+		// Create. pixels is an offset when a pixel unpack buffer is bound.
+		void Upload(int level, const void* pixels);
+		void Upload(int level, int x, int y, int width, int height, const void* pixels);
+
 		void Bind(TextureUnit texUnit);
 		void Bind();
+		void Delete();
+		// Rebuilds levels 1..n from level 0, after level 0 was uploaded separately
+		void GenerateMipmaps();
 		void SetXWrap(TextureWrap xWrap);
 		void SetYWrap(TextureWrap yWrap);
 		void SetMinFilter(TextureMinFilter minFilter);
@@ -58,18 +102,31 @@ namespace nether {
 			return m_height;
 		}
 
+		int GetLevelCount()
+		{
+			return m_levels;
+		}
+
 		unsigned int GetTextureID()
 		{
 			return m_texture;
 		}
 
 	private:
+		void CreateStorage(int width, int height, int levels, unsigned int internalFormat, unsigned int format, unsigned int type);
+
 		TextureWrap m_xWrap = TextureWrap::Repeat;
 		TextureWrap m_yWrap = TextureWrap::Repeat;
 		TextureMinFilter m_minFilter = TextureMinFilter::Nearest;
 		TextureMagFilter m_magFilter = TextureMagFilter::Nearest;
 		int m_width = 0;
 		int m_height = 0;
+		int m_levels = 0;
+		unsigned int m_internalFormat = GL_RGBA8;
+		unsigned int m_pixelFormat = GL_RGBA;
+		unsigned int m_pixelType = GL_UNSIGNED_BYTE;
+		// Size of a 4x4 block for compressed formats, 0 otherwise
+		int m_blockBytes = 0;
 		unsigned int m_texture = 0;
 	};
 
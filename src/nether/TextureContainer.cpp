@@ -0,0 +1,326 @@
+#include "TextureContainer.h"
+
+#include "nether/Texture.h"
+
+#include <stdio.h>
+#include <string.h>
+
+namespace nether {
+
+	namespace {
+
+		// Both formats are little endian, like every platform we run on
+		unsigned int ReadU32(const unsigned char* bytes)
+		{
+			unsigned int value;
+			memcpy(&value, bytes, sizeof(value));
+			return value;
+		}
+
+		unsigned long long ReadU64(const unsigned char* bytes)
+		{
+			unsigned long long value;
+			memcpy(&value, bytes, sizeof(value));
+			return value;
+		}
+
+		constexpr unsigned int FourCC(char a, char b, char c, char d)
+		{
+			return (unsigned int)(unsigned char)a | ((unsigned int)(unsigned char)b << 8) |
+				((unsigned int)(unsigned char)c << 16) | ((unsigned int)(unsigned char)d << 24);
+		}
+
+		bool EndsWith(const std::string& text, const char* suffix)
+		{
+			const size_t length = strlen(suffix);
+			if (text.size() < length)
+			{
+				return false;
+			}
+			for (size_t i = 0; i < length; i++)
+			{
+				char c = text[text.size() - length + i];
+				c = (c >= 'A' && c <= 'Z') ? char(c - 'A' + 'a') : c;
+				if (c != suffix[i])
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		bool ReadFile(const std::string& filePath, std::vector<unsigned char>& bytes)
+		{
+			FILE* file = fopen(filePath.c_str(), "rb");
+			if (file == nullptr)
+			{
+				return false;
+			}
+
+			fseek(file, 0, SEEK_END);
+			const long size = ftell(file);
+			fseek(file, 0, SEEK_SET);
+			bytes.resize(size > 0 ? size_t(size) : 0);
+			const bool read = size > 0 && fread(bytes.data(), 1, bytes.size(), file) == bytes.size();
+			fclose(file);
+			return read;
+		}
+
+		// Sizes and level counts come straight from the file header, so they are checked
+		// before being used to compute level sizes or allocate storage
+		const char* SetSize(TextureContainer& container, unsigned int width, unsigned int height, unsigned int levelCount)
+		{
+			if (width == 0 || height == 0 || width > unsigned(Texture::kMaxSize) || height > unsigned(Texture::kMaxSize))
+			{
+				return "bad size";
+			}
+			container.width = int(width);
+			container.height = int(height);
+			if (levelCount > unsigned(Texture::GetMipLevelCount(container.width, container.height)))
+			{
+				return "bad level count";
+			}
+			return nullptr;
+		}
+
+		// Checks one level against the file and appends it to the container
+		bool AddLevel(TextureContainer& container, const std::vector<unsigned char>& bytes, unsigned long long offset, unsigned long long size)
+		{
+			const int level = int(container.levels.size());
+			TextureLevelData data;
+			data.width = container.width >> level > 0 ? container.width >> level : 1;
+			data.height = container.height >> level > 0 ? container.height >> level : 1;
+			data.size = size_t(TextureFormatUtils::GetImageSize(container.format, data.width, data.height));
+			if (size < data.size || offset > bytes.size() || bytes.size() - offset < data.size)
+			{
+				return false;
+			}
+
+			data.offset = container.data.size();
+			container.data.insert(container.data.end(), bytes.begin() + offset, bytes.begin() + offset + data.size);
+			container.levels.push_back(data);
+			return true;
+		}
+
+		constexpr size_t kDdsHeaderSize = 4 + 124;
+		constexpr size_t kDdsDx10HeaderSize = 20;
+		constexpr unsigned int kDdsMipMapCount = 0x20000;
+		constexpr unsigned int kDdsFourCC = 0x4;
+		constexpr unsigned int kDdsRgb = 0x40;
+		constexpr unsigned int kDdsCubeMap = 0x200;
+		constexpr unsigned int kDdsVolume = 0x200000;
+
+		bool GetDxgiFormat(unsigned int dxgiFormat, TextureFormat& format)
+		{
+			switch (dxgiFormat)
+			{
+			case 28: case 29: format = TextureFormat::RGBA8; return true;  // R8G8B8A8_UNORM(_SRGB)
+			case 71: case 72: format = TextureFormat::BC1; return true;
+			case 77: case 78: format = TextureFormat::BC3; return true;
+			case 83: format = TextureFormat::BC5; return true;              // BC5_UNORM
+			case 98: case 99: format = TextureFormat::BC7; return true;
+			default: return false;
+			}
+		}
+
+		const char* LoadDds(const std::vector<unsigned char>& bytes, TextureContainer& container)
+		{
+			if (bytes.size() < kDdsHeaderSize)
+			{
+				return "truncated header";
+			}
+
+			const unsigned char* header = bytes.data() + 4;
+			const unsigned int flags = ReadU32(header + 4);
+			const unsigned int mipCount = (flags & kDdsMipMapCount) != 0 ? ReadU32(header + 24) : 1;
+			const unsigned int pixelFlags = ReadU32(header + 76);
+			const unsigned int fourCC = ReadU32(header + 80);
+			const unsigned int caps2 = ReadU32(header + 108);
+
+			const char* sizeError = SetSize(container, ReadU32(header + 12), ReadU32(header + 8), mipCount);
+			if (sizeError != nullptr)
+			{
+				return sizeError;
+			}
+
+			if ((caps2 & (kDdsCubeMap | kDdsVolume)) != 0)
+			{
+				return "cube maps and volumes are not supported";
+			}
+
+			size_t dataOffset = kDdsHeaderSize;
+			if ((pixelFlags & kDdsFourCC) != 0)
+			{
+				if (fourCC == FourCC('D', 'X', 'T', '1'))
+				{
+					container.format = TextureFormat::BC1;
+				}
+				else if (fourCC == FourCC('D', 'X', 'T', '5'))
+				{
+					container.format = TextureFormat::BC3;
+				}
+				else if (fourCC == FourCC('A', 'T', 'I', '2') || fourCC == FourCC('B', 'C', '5', 'U'))
+				{
+					container.format = TextureFormat::BC5;
+				}
+				else if (fourCC == FourCC('D', 'X', '1', '0'))
+				{
+					if (bytes.size() < kDdsHeaderSize + kDdsDx10HeaderSize)
+					{
+						return "truncated header";
+					}
+					const unsigned char* dx10 = bytes.data() + kDdsHeaderSize;
+					const unsigned int resourceDimension = ReadU32(dx10 + 4);
+					const unsigned int arraySize = ReadU32(dx10 + 12);
+					if (resourceDimension != 3 || arraySize > 1 || (ReadU32(dx10 + 8) & 0x4) != 0)
+					{
+						return "only 2D textures are supported";
+					}
+					if (!GetDxgiFormat(ReadU32(dx10), container.format))
+					{
+						return "unsupported DXGI format";
+					}
+					dataOffset += kDdsDx10HeaderSize;
+				}
+				else
+				{
+					return "unsupported FourCC";
+				}
+			}
+			else if ((pixelFlags & kDdsRgb) != 0 && ReadU32(header + 84) == 32 &&
+				ReadU32(header + 88) == 0x000000FF && ReadU32(header + 92) == 0x0000FF00 && ReadU32(header + 96) == 0x00FF0000)
+			{
+				container.format = TextureFormat::RGBA8;
+			}
+			else
+			{
+				return "unsupported pixel format";
+			}
+
+			unsigned long long offset = dataOffset;
+			for (unsigned int level = 0; level < (mipCount > 0 ? mipCount : 1); level++)
+			{
+				const unsigned long long remaining = offset < bytes.size() ? bytes.size() - offset : 0;
+				if (!AddLevel(container, bytes, offset, remaining))
+				{
+					return "truncated level data";
+				}
+				offset += container.levels.back().size;
+			}
+			return nullptr;
+		}
+
+		constexpr unsigned char kKtx2Identifier[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+		constexpr size_t kKtx2HeaderSize = 80;
+		constexpr size_t kKtx2LevelIndexSize = 24;
+
+		bool GetVkFormat(unsigned int vkFormat, TextureFormat& format)
+		{
+			switch (vkFormat)
+			{
+			case 23: case 29: format = TextureFormat::RGB8; return true;    // R8G8B8_UNORM(_SRGB)
+			case 37: case 43: format = TextureFormat::RGBA8; return true;   // R8G8B8A8_UNORM(_SRGB)
+			case 131: case 132: case 133: case 134: format = TextureFormat::BC1; return true;
+			case 137: case 138: format = TextureFormat::BC3; return true;
+			case 141: format = TextureFormat::BC5; return true;             // BC5_UNORM_BLOCK
+			case 145: case 146: format = TextureFormat::BC7; return true;
+			default: return false;
+			}
+		}
+
+		const char* LoadKtx2(const std::vector<unsigned char>& bytes, TextureContainer& container)
+		{
+			if (bytes.size() < kKtx2HeaderSize)
+			{
+				return "truncated header";
+			}
+
+			const unsigned char* header = bytes.data() + sizeof(kKtx2Identifier);
+			if (!GetVkFormat(ReadU32(header), container.format))
+			{
+				return "unsupported Vulkan format";
+			}
+			const unsigned int width = ReadU32(header + 8);
+			const unsigned int height = ReadU32(header + 12);
+			const unsigned int depth = ReadU32(header + 16);
+			const unsigned int layerCount = ReadU32(header + 20);
+			const unsigned int faceCount = ReadU32(header + 24);
+			const unsigned int levelCount = ReadU32(header + 28);
+			const unsigned int supercompression = ReadU32(header + 32);
+
+			if (height == 0 || depth != 0 || layerCount != 0 || faceCount != 1)
+			{
+				return "only 2D textures are supported";
+			}
+			if (supercompression != 0)
+			{
+				return "supercompression is not supported";
+			}
+
+			const char* sizeError = SetSize(container, width, height, levelCount);
+			if (sizeError != nullptr)
+			{
+				return sizeError;
+			}
+
+			// A level count of 0 asks for mipmaps to be generated, only level 0 is stored
+			const unsigned int storedLevels = levelCount > 0 ? levelCount : 1;
+			if (bytes.size() < kKtx2HeaderSize + storedLevels * kKtx2LevelIndexSize)
+			{
+				return "truncated level index";
+			}
+
+			for (unsigned int level = 0; level < storedLevels; level++)
+			{
+				const unsigned char* index = bytes.data() + kKtx2HeaderSize + level * kKtx2LevelIndexSize;
+				if (!AddLevel(container, bytes, ReadU64(index), ReadU64(index + 8)))
+				{
+					return "truncated level data";
+				}
+			}
+			return nullptr;
+		}
+
+	}
+
+	bool TextureContainer::IsContainerFile(const std::string& filePath)
+	{
+		return EndsWith(filePath, ".dds") || EndsWith(filePath, ".ktx2");
+	}
+
+	bool TextureContainer::Load(const std::string& filePath, TextureContainer& container)
+	{
+		container = TextureContainer();
+
+		std::vector<unsigned char> bytes;
+		if (!ReadFile(filePath, bytes))
+		{
+			printf("TextureContainer: could not read %s\n", filePath.c_str());
+			return false;
+		}
+
+		const char* error = "unknown file type";
+		if (bytes.size() >= 4 && ReadU32(bytes.data()) == FourCC('D', 'D', 'S', ' '))
+		{
+			error = LoadDds(bytes, container);
+		}
+		else if (bytes.size() >= sizeof(kKtx2Identifier) && memcmp(bytes.data(), kKtx2Identifier, sizeof(kKtx2Identifier)) == 0)
+		{
+			error = LoadKtx2(bytes, container);
+		}
+
+		if (error == nullptr && container.width <= 0)
+		{
+			error = "empty image";
+		}
+
+		if (error != nullptr)
+		{
+			printf("TextureContainer: %s: %s\n", filePath.c_str(), error);
+			container = TextureContainer();
+			return false;
+		}
+		return true;
+	}
+
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "nether/TextureFormat.h"
+
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+namespace nether
+{
+
+    // Where one mip level lives in TextureContainer::data
+    struct TextureLevelData
+    {
+        int width = 0;
+        int height = 0;
+        size_t offset = 0;
+        size_t size = 0;
+    };
+
+    // Texture stored ready for the GPU in a DDS or KTX2 file: every level of its mip
+    // chain, already in the GPU format (usually block compressed), back to back in
+    // data from the full size level down. Loading one is a read and a copy, no
+    // decoding.
+    //
+    // Only 2D textures in a TextureFormat are supported: BC1, BC3, BC5, BC7 and
+    // RGBA8, RGB8 for KTX2. sRGB variants load as their linear counterparts, like
+    // every other texture here. No cube maps, arrays or KTX2 supercompression.
+    struct TextureContainer
+    {
+        TextureFormat format = TextureFormat::RGBA8;
+        int width = 0;
+        int height = 0;
+        std::vector<TextureLevelData> levels;
+        std::vector<unsigned char> data;
+
+        bool IsValid() const
+        {
+            return !levels.empty();
+        }
+
+        // By extension, .dds or .ktx2
+        static bool IsContainerFile(const std::string& filePath);
+
+        // Reads a DDS or KTX2 file, told apart by their magic numbers. Prints why and
+        // returns false when the file can't be used.
+        static bool Load(const std::string& filePath, TextureContainer& container);
+    };
+
+}
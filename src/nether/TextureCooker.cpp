@@ -0,0 +1,234 @@
+#define STB_DXT_IMPLEMENTATION
+#include <stb_dxt.h>
+
+#include "TextureCooker.h"
+
+#include "nether/CookedTexture.h"
+#include "nether/Texture.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <utility>
+#include <vector>
+
+namespace nether {
+
+	namespace {
+
+		constexpr float kPi = 3.14159265358979f;
+		constexpr float kLanczosRadius = 2.0f;
+
+		float Sinc(float x)
+		{
+			x *= kPi;
+			return fabsf(x) < 1e-5f ? 1.0f : sinf(x) / x;
+		}
+
+		float Lanczos(float x)
+		{
+			return fabsf(x) < kLanczosRadius ? Sinc(x) * Sinc(x / kLanczosRadius) : 0.0f;
+		}
+
+		// Source texels, and their weights, contributing to one destination texel
+		struct FilterTaps
+		{
+			int first = 0;
+			std::vector<float> weights;
+		};
+
+		// The kernel is stretched by the scale so every source texel is covered when
+		// minifying by more than 2
+		std::vector<FilterTaps> ComputeTaps(int sourceSize, int size)
+		{
+			const float scale = float(sourceSize) / float(size);
+			const float support = kLanczosRadius * scale;
+
+			std::vector<FilterTaps> taps(size);
+			for (int i = 0; i < size; i++)
+			{
+				const float center = (float(i) + 0.5f) * scale;
+				FilterTaps& tap = taps[i];
+				tap.first = int(floorf(center - support));
+				const int last = int(ceilf(center + support));
+
+				float sum = 0.0f;
+				for (int source = tap.first; source <= last; source++)
+				{
+					const float weight = Lanczos((float(source) + 0.5f - center) / scale);
+					tap.weights.push_back(weight);
+					sum += weight;
+				}
+				for (float& weight : tap.weights)
+				{
+					weight /= sum;
+				}
+			}
+			return taps;
+		}
+
+		int Clamp(int value, int low, int high)
+		{
+			return value < low ? low : (value > high ? high : value);
+		}
+
+		// Separable resize of RGBA float texels, edges clamped
+		std::vector<float> Resample(const std::vector<float>& source, int sourceWidth, int sourceHeight, int width, int height)
+		{
+			const std::vector<FilterTaps> columns = ComputeTaps(sourceWidth, width);
+			std::vector<float> rows(size_t(width) * sourceHeight * 4);
+			for (int y = 0; y < sourceHeight; y++)
+			{
+				for (int x = 0; x < width; x++)
+				{
+					const FilterTaps& tap = columns[x];
+					float* out = &rows[(size_t(y) * width + x) * 4];
+					for (size_t k = 0; k < tap.weights.size(); k++)
+					{
+						const float* in = &source[(size_t(y) * sourceWidth + Clamp(tap.first + int(k), 0, sourceWidth - 1)) * 4];
+						for (int c = 0; c < 4; c++)
+						{
+							out[c] += in[c] * tap.weights[k];
+						}
+					}
+				}
+			}
+
+			const std::vector<FilterTaps> lines = ComputeTaps(sourceHeight, height);
+			std::vector<float> result(size_t(width) * height * 4);
+			for (int y = 0; y < height; y++)
+			{
+				const FilterTaps& tap = lines[y];
+				for (size_t k = 0; k < tap.weights.size(); k++)
+				{
+					const float* in = &rows[size_t(Clamp(tap.first + int(k), 0, sourceHeight - 1)) * width * 4];
+					float* out = &result[size_t(y) * width * 4];
+					for (int i = 0; i < width * 4; i++)
+					{
+						out[i] += in[i] * tap.weights[k];
+					}
+				}
+			}
+			return result;
+		}
+
+		unsigned char ToByte(float value)
+		{
+			value = value < 0.0f ? 0.0f : (value > 1.0f ? 1.0f : value);
+			return (unsigned char)(value * 255.0f + 0.5f);
+		}
+
+		// Texels hold premultiplied colors; Lanczos lobes can push them past alpha
+		std::vector<unsigned char> ToRGBA8(const std::vector<float>& texels, bool premultiplied)
+		{
+			std::vector<unsigned char> pixels(texels.size());
+			for (size_t i = 0; i < texels.size(); i += 4)
+			{
+				const float alpha = texels[i + 3] < 0.0f ? 0.0f : (texels[i + 3] > 1.0f ? 1.0f : texels[i + 3]);
+				for (int c = 0; c < 3; c++)
+				{
+					const float color = texels[i + c] > alpha ? alpha : texels[i + c];
+					pixels[i + c] = ToByte(premultiplied ? color : (alpha > 0.0f ? color / alpha : 0.0f));
+				}
+				pixels[i + 3] = ToByte(alpha);
+			}
+			return pixels;
+		}
+
+		std::vector<unsigned char> Compress(const std::vector<unsigned char>& pixels, int width, int height, TextureFormat format)
+		{
+			const int blockBytes = TextureFormatUtils::GetBlockBytes(format);
+			std::vector<unsigned char> blocks(size_t(TextureFormatUtils::GetImageSize(format, width, height)));
+			unsigned char* out = blocks.data();
+
+			for (int blockY = 0; blockY < height; blockY += 4)
+			{
+				for (int blockX = 0; blockX < width; blockX += 4)
+				{
+					// Blocks past the edge repeat the last row and column
+					unsigned char rgba[16 * 4];
+					unsigned char rg[16 * 2];
+					for (int y = 0; y < 4; y++)
+					{
+						for (int x = 0; x < 4; x++)
+						{
+							const unsigned char* in = &pixels[(size_t(Clamp(blockY + y, 0, height - 1)) * width + Clamp(blockX + x, 0, width - 1)) * 4];
+							const int texel = y * 4 + x;
+							for (int c = 0; c < 4; c++)
+							{
+								rgba[texel * 4 + c] = in[c];
+							}
+							rg[texel * 2] = in[0];
+							rg[texel * 2 + 1] = in[1];
+						}
+					}
+
+					if (format == TextureFormat::BC5)
+					{
+						stb_compress_bc5_block(out, rg);
+					}
+					else
+					{
+						stb_compress_dxt_block(out, rgba, format == TextureFormat::BC3 ? 1 : 0, STB_DXT_HIGHQUAL);
+					}
+					out += blockBytes;
+				}
+			}
+			return blocks;
+		}
+
+	}
+
+	bool TextureCooker::Cook(const std::string& inputPath, const std::string& outputPath, const TextureCookOptions& options)
+	{
+		int width = 0;
+		int height = 0;
+		TextureFormat sourceFormat = TextureFormat::RGBA8;
+		unsigned char* source = Texture::DecodeFile(inputPath, width, height, sourceFormat);
+		if (source == nullptr)
+		{
+			printf("TextureCooker: could not decode %s\n", inputPath.c_str());
+			return false;
+		}
+
+		const int channels = TextureFormatUtils::GetBytesPerPixel(sourceFormat);
+		bool opaque = true;
+		std::vector<float> texels(size_t(width) * height * 4);
+		for (size_t i = 0; i < size_t(width) * height; i++)
+		{
+			const float alpha = channels == 4 ? source[i * channels + 3] / 255.0f : 1.0f;
+			for (int c = 0; c < 3; c++)
+			{
+				texels[i * 4 + c] = source[i * channels + c] / 255.0f * alpha;
+			}
+			texels[i * 4 + 3] = alpha;
+			opaque = opaque && alpha == 1.0f;
+		}
+		Texture::FreeDecoded(source);
+
+		TextureFormat format = options.format;
+		if (options.autoCompress)
+		{
+			format = opaque ? TextureFormat::BC1 : TextureFormat::BC3;
+		}
+		if (format != TextureFormat::RGBA8 && format != TextureFormat::BC1 && format != TextureFormat::BC3 && format != TextureFormat::BC5)
+		{
+			printf("TextureCooker: %s: can only cook to RGBA8, BC1, BC3 or BC5\n", inputPath.c_str());
+			return false;
+		}
+
+		int levelCount = options.mipmaps ? Texture::GetMipLevelCount(width, height) : 1;
+		levelCount = levelCount < CookedTextureHeader::kMaxLevels ? levelCount : CookedTextureHeader::kMaxLevels;
+
+		std::vector<std::vector<unsigned char>> levels;
+		for (int level = 0; level < levelCount; level++)
+		{
+			const int levelWidth = width >> level > 0 ? width >> level : 1;
+			const int levelHeight = height >> level > 0 ? height >> level : 1;
+			std::vector<unsigned char> pixels = ToRGBA8(level == 0 ? texels : Resample(texels, width, height, levelWidth, levelHeight), options.premultiplyAlpha);
+			levels.push_back(format == TextureFormat::RGBA8 ? std::move(pixels) : Compress(pixels, levelWidth, levelHeight, format));
+		}
+
+		return CookedTexture::Write(outputPath, format, width, height, options.premultiplyAlpha ? unsigned(kCookedTexturePremultiplied) : 0u, levels);
+	}
+
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "nether/TextureFormat.h"
+
+#include <string>
+
+namespace nether
+{
+
+    struct TextureCookOptions
+    {
+        // RGBA8, BC1, BC3 or BC5 (red and green only)
+        TextureFormat format = TextureFormat::RGBA8;
+        // Picks BC1 for opaque images and BC3 for the others, ignoring format
+        bool autoCompress = false;
+        bool premultiplyAlpha = true;
+        bool mipmaps = true;
+    };
+
+    // Turns an image file (anything stb_image reads) into a CookedTexture file, doing
+    // offline everything loading it would otherwise do at run time: decoding, alpha
+    // premultiplication, the mip chain and block compression.
+    //
+    // Mipmaps are resampled from the full size image with a Lanczos-2 filter on
+    // premultiplied colors, so transparent texels don't bleed into their neighbours;
+    // with premultiplyAlpha off the result is divided back by alpha. BC formats are
+    // encoded with stb_dxt at its high quality setting. Like the rest of the engine,
+    // colors are treated as linear.
+    class TextureCooker
+    {
+    public:
+        // Prints why and returns false on failure
+        static bool Cook(const std::string& inputPath, const std::string& outputPath, const TextureCookOptions& options);
+    };
+
+}
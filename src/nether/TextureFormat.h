@@ -2,6 +2,13 @@
 
 #include <nether/NetherGL.h>
 
+// S3TC is still an extension on desktop GL and not every loader defines its enums
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT 0x83F1
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
 
 namespace nether
 {
@@ -26,7 +33,13 @@ namespace nether
 		Stencil8,       // 8-bit stencil
 
 		// Combined formats
-		Depth24Stencil8 // 24-bit depth + 8-bit stencil
+		Depth24Stencil8, // 24-bit depth + 8-bit stencil
+
+		// Block compressed formats, 4x4 pixel blocks
+		BC1,            // RGB + 1-bit alpha, 8 bytes per block (DXT1)
+		BC3,            // RGBA, 16 bytes per block (DXT5)
+		BC5,            // Two channel, 16 bytes per block (normal maps)
+		BC7             // High quality RGBA, 16 bytes per block
     };
 
 	class TextureFormatUtils
@@ -49,6 +62,10 @@ namespace nether
 			case TextureFormat::Depth32F: return GL_DEPTH_COMPONENT32F;
 			case TextureFormat::Stencil8: return GL_STENCIL_INDEX8;
 			case TextureFormat::Depth24Stencil8: return GL_DEPTH24_STENCIL8;
+			case TextureFormat::BC1: return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+			case TextureFormat::BC3: return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+			case TextureFormat::BC5: return GL_COMPRESSED_RG_RGTC2;
+			case TextureFormat::BC7: return GL_COMPRESSED_RGBA_BPTC_UNORM;
 			default: return GL_RGBA8;
 			}
 		}
@@ -64,10 +81,14 @@ namespace nether
 			case TextureFormat::RGBA8:
 			case TextureFormat::RGBA16F:
 			case TextureFormat::RGBA32F:
+			case TextureFormat::BC1:
+			case TextureFormat::BC3:
+			case TextureFormat::BC7:
 				return GL_RGBA;
 			case TextureFormat::R8:
 				return GL_RED;
 			case TextureFormat::RG8:
+			case TextureFormat::BC5:
 				return GL_RG;
 			case TextureFormat::Depth16:
 			case TextureFormat::Depth24:
@@ -111,6 +132,76 @@ namespace nether
 			}
 		}
 
+		// Size of one pixel as uploaded from client memory or a pixel unpack buffer,
+		// 0 for compressed formats, see GetImageSize
+		static int GetBytesPerPixel(TextureFormat format)
+		{
+			switch(format)
+			{
+			case TextureFormat::BC1:
+			case TextureFormat::BC3:
+			case TextureFormat::BC5:
+			case TextureFormat::BC7:
+				return 0;
+			case TextureFormat::R8:
+			case TextureFormat::Stencil8:
+				return 1;
+			case TextureFormat::RG8:
+			case TextureFormat::Depth16:
+				return 2;
+			case TextureFormat::RGB8:
+				return 3;
+			case TextureFormat::RGBA8:
+			case TextureFormat::Depth24:
+			case TextureFormat::Depth32F:
+			case TextureFormat::Depth24Stencil8:
+				return 4;
+			case TextureFormat::RGB16F:
+				return 6;
+			case TextureFormat::RGBA16F:
+				return 8;
+			case TextureFormat::RGB32F:
+				return 12;
+			case TextureFormat::RGBA32F:
+				return 16;
+			default:
+				return 4;
+			}
+		}
+
+		static bool IsCompressed(TextureFormat format)
+		{
+			return GetBlockBytes(format) != 0;
+		}
+
+		// Size of one 4x4 block of a compressed format, 0 for other formats
+		static int GetBlockBytes(TextureFormat format)
+		{
+			switch(format)
+			{
+			case TextureFormat::BC1:
+				return 8;
+			case TextureFormat::BC3:
+			case TextureFormat::BC5:
+			case TextureFormat::BC7:
+				return 16;
+			default:
+				return 0;
+			}
+		}
+
+		// Bytes of tightly packed data for a width x height image, compressed images
+		// are padded to whole blocks
+		static long long GetImageSize(TextureFormat format, int width, int height)
+		{
+			const int blockBytes = GetBlockBytes(format);
+			if (blockBytes != 0)
+			{
+				return (long long)((width + 3) / 4) * ((height + 3) / 4) * blockBytes;
+			}
+			return (long long)width * height * GetBytesPerPixel(format);
+		}
+
 		static bool IsDepthFormat(TextureFormat format)
 		{
 			return format == TextureFormat::Depth16 ||
@@ -0,0 +1,317 @@
+#include "TextureLoader.h"
+
+#include "nether/CpuProfiler.h"
+
+#include <stdio.h>
+#include <string.h>
+
+namespace nether {
+
+	void TextureLoader::Init(int workerCount, long long uploadBudgetBytes, bool useStagingBuffer)
+	{
+		if (workerCount <= 0)
+		{
+			const int cores = int(std::thread::hardware_concurrency());
+			workerCount = cores > 1 ? cores - 1 : 1;
+		}
+
+		m_uploadBudget = uploadBudgetBytes;
+		if (useStagingBuffer)
+		{
+			m_uploader.Init(uploadBudgetBytes);
+		}
+
+		m_stopping = false;
+		for (int i = 0; i < workerCount; i++)
+		{
+			m_workers.emplace_back(&TextureLoader::WorkerMain, this);
+		}
+	}
+
+	void TextureLoader::Shutdown()
+	{
+		if (m_workers.empty())
+		{
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_jobsMutex);
+			m_stopping = true;
+		}
+		m_jobsCondition.notify_all();
+		for (std::thread& worker : m_workers)
+		{
+			worker.join();
+		}
+		m_workers.clear();
+
+		for (TextureHandle& handle : m_jobs)
+		{
+			handle->m_state.store(AsyncTextureState::Failed, std::memory_order_release);
+		}
+		m_jobs.clear();
+
+		DecodedImage image;
+		while (m_decoded.Pop(image))
+		{
+			m_waiting.push_back(std::move(image));
+		}
+		for (DecodedImage& waiting : m_waiting)
+		{
+			waiting.handle->m_state.store(AsyncTextureState::Failed, std::memory_order_release);
+		}
+		m_waiting.clear();
+		m_pending = 0;
+
+		if (m_uploader.IsInitialized())
+		{
+			m_uploader.Shutdown();
+		}
+	}
+
+	TextureHandle TextureLoader::Load(const std::string& filePath, bool createMipMaps)
+	{
+		TextureHandle handle = std::make_shared<AsyncTexture>();
+		handle->m_path = filePath;
+		handle->m_createMipMaps = createMipMaps;
+
+		if (m_workers.empty())
+		{
+			printf("TextureLoader: Load before Init, %s is not loaded\n", filePath.c_str());
+			handle->m_state.store(AsyncTextureState::Failed, std::memory_order_release);
+			return handle;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_jobsMutex);
+			m_jobs.push_back(handle);
+		}
+		m_jobsCondition.notify_one();
+
+		m_pending++;
+		m_stats.requested++;
+		return handle;
+	}
+
+	void TextureLoader::Update()
+	{
+		NETHER_CPU_SCOPE("TextureUploads");
+
+		DecodedImage image;
+		while (m_decoded.Pop(image))
+		{
+			m_waiting.push_back(std::move(image));
+		}
+
+		const bool staging = m_uploader.IsInitialized();
+		if (staging)
+		{
+			m_uploader.BeginFrame();
+		}
+
+		long long uploadedBytes = 0;
+		while (!m_waiting.empty())
+		{
+			DecodedImage& next = m_waiting.front();
+			long long bytes = next.GetByteSize();
+			if (next.pixels != nullptr && next.handle->m_createMipMaps)
+			{
+				bytes += bytes / 3;
+			}
+
+			if (next.IsValid() && uploadedBytes > 0 && uploadedBytes + bytes > m_uploadBudget)
+			{
+				m_stats.deferredUpdates++;
+				break;
+			}
+
+			const bool counts = next.IsValid() && next.handle.use_count() > 1;
+			if (!Resolve(next))
+			{
+				m_stats.deferredUpdates++;
+				break;
+			}
+			if (counts)
+			{
+				uploadedBytes += bytes;
+			}
+			m_waiting.pop_front();
+		}
+
+		if (staging)
+		{
+			m_uploader.EndFrame();
+		}
+	}
+
+	bool TextureLoader::Resolve(DecodedImage& image)
+	{
+		AsyncTexture& texture = *image.handle;
+
+		if (!image.IsValid())
+		{
+			printf("TextureLoader: failed to load %s\n", texture.m_path.c_str());
+			texture.m_state.store(AsyncTextureState::Failed, std::memory_order_release);
+			m_stats.failed++;
+			m_pending--;
+			return true;
+		}
+
+		// The loader holds the last reference, nobody is waiting for this texture
+		if (image.handle.use_count() == 1)
+		{
+			m_stats.dropped++;
+			m_pending--;
+			return true;
+		}
+
+		if (!Upload(texture, image))
+		{
+			return false;
+		}
+
+		texture.m_state.store(AsyncTextureState::Ready, std::memory_order_release);
+		m_stats.uploaded++;
+		m_stats.uploadedBytes += (unsigned long long)image.GetByteSize();
+		m_pending--;
+		return true;
+	}
+
+	std::vector<TextureDesc> TextureLoader::DecodedImage::GetStoredLevels() const
+	{
+		// The pixels are only read from, TextureDesc just doesn't say so
+		std::vector<TextureDesc> levels;
+		for (const TextureLevelData& level : container.levels)
+		{
+			unsigned char* data = const_cast<unsigned char*>(container.data.data()) + level.offset;
+			levels.push_back({ level.width, level.height, data, container.format });
+		}
+		if (cooked.IsOpen())
+		{
+			for (int level = 0; level < cooked.GetLevelCount(); level++)
+			{
+				const CookedTextureLevel& data = cooked.GetLevel(level);
+				unsigned char* pixels = const_cast<unsigned char*>(cooked.GetLevelData(level));
+				levels.push_back({ int(data.width), int(data.height), pixels, cooked.GetFormat() });
+			}
+		}
+		return levels;
+	}
+
+	long long TextureLoader::DecodedImage::GetByteSize() const
+	{
+		if (pixels != nullptr)
+		{
+			return TextureFormatUtils::GetImageSize(format, width, height);
+		}
+
+		long long bytes = 0;
+		for (const TextureDesc& level : GetStoredLevels())
+		{
+			bytes += TextureFormatUtils::GetImageSize(level.format, level.width, level.height);
+		}
+		return bytes;
+	}
+
+	bool TextureLoader::Upload(AsyncTexture& texture, const DecodedImage& image)
+	{
+		const std::vector<TextureDesc> levels = image.GetStoredLevels();
+		const long long bytes = image.GetByteSize();
+		if (!m_uploader.IsInitialized() || !m_uploader.CanStage(bytes))
+		{
+			if (!levels.empty())
+			{
+				texture.m_texture.Create(levels.data(), int(levels.size()));
+			}
+			else
+			{
+				texture.m_texture.Create(image.width, image.height, image.pixels.get(), image.format, texture.m_createMipMaps);
+			}
+			return true;
+		}
+
+		// Staged before the texture exists so a full region leaves nothing behind
+		StreamingAllocation staged = m_uploader.Stage(bytes);
+		if (!staged.IsValid())
+		{
+			return false;
+		}
+
+		if (!levels.empty())
+		{
+			texture.m_texture.Create(levels[0].width, levels[0].height, int(levels.size()), levels[0].format);
+			long long offset = 0;
+			for (size_t level = 0; level < levels.size(); level++)
+			{
+				const TextureDesc& desc = levels[level];
+				StreamingAllocation levelStaged;
+				levelStaged.data = static_cast<unsigned char*>(staged.data) + offset;
+				levelStaged.offset = staged.offset + offset;
+				levelStaged.size = TextureFormatUtils::GetImageSize(desc.format, desc.width, desc.height);
+				memcpy(levelStaged.data, desc.pixels, size_t(levelStaged.size));
+				m_uploader.Upload(texture.m_texture, int(level), desc.width, desc.height, levelStaged);
+				offset += levelStaged.size;
+			}
+			m_stats.stagedUploads++;
+			return true;
+		}
+
+		memcpy(staged.data, image.pixels.get(), size_t(bytes));
+
+		const int levelCount = texture.m_createMipMaps ? Texture::GetMipLevelCount(image.width, image.height) : 1;
+		texture.m_texture.Create(image.width, image.height, levelCount, image.format);
+		m_uploader.Upload(texture.m_texture, 0, image.width, image.height, staged);
+		if (texture.m_createMipMaps)
+		{
+			texture.m_texture.GenerateMipmaps();
+		}
+		m_stats.stagedUploads++;
+		return true;
+	}
+
+	void TextureLoader::WorkerMain()
+	{
+		for (;;)
+		{
+			TextureHandle handle;
+			{
+				std::unique_lock<std::mutex> lock(m_jobsMutex);
+				m_jobsCondition.wait(lock, [this] { return m_stopping || !m_jobs.empty(); });
+				if (m_stopping)
+				{
+					return;
+				}
+				handle = std::move(m_jobs.front());
+				m_jobs.pop_front();
+			}
+
+			NETHER_CPU_SCOPE("DecodeTexture");
+
+			DecodedImage image;
+			if (CookedTexture::IsCookedFile(handle->m_path))
+			{
+				// Nothing to decode, only the file's pages to bring in
+				if (image.cooked.Open(handle->m_path))
+				{
+					image.cooked.Prefetch();
+				}
+			}
+			else if (TextureContainer::IsContainerFile(handle->m_path))
+			{
+				TextureContainer::Load(handle->m_path, image.container);
+			}
+			else
+			{
+				image.pixels.reset(Texture::DecodeFile(handle->m_path, image.width, image.height, image.format));
+			}
+			if (image.IsValid())
+			{
+				handle->m_state.store(AsyncTextureState::Decoded, std::memory_order_release);
+			}
+			image.handle = std::move(handle);
+			m_decoded.Push(std::move(image));
+		}
+	}
+
+}
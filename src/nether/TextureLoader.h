@@ -0,0 +1,210 @@
+#pragma once
+
+#include "nether/CookedTexture.h"
+#include "nether/MpscQueue.h"
+#include "nether/Texture.h"
+#include "nether/TextureContainer.h"
+#include "nether/TextureUploader.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace nether
+{
+
+    enum class AsyncTextureState
+    {
+        Queued,     // waiting for or being decoded by a worker
+        Decoded,    // waiting for its upload on the GL thread
+        Ready,
+        Failed
+    };
+
+    // Texture requested from a TextureLoader. The state can be polled from any thread,
+    // the texture itself is only usable on the GL thread once IsReady.
+    class AsyncTexture
+    {
+    public:
+        AsyncTextureState GetState() const
+        {
+            return m_state.load(std::memory_order_acquire);
+        }
+
+        bool IsReady() const
+        {
+            return GetState() == AsyncTextureState::Ready;
+        }
+
+        bool HasFailed() const
+        {
+            return GetState() == AsyncTextureState::Failed;
+        }
+
+        Texture& GetTexture()
+        {
+            return m_texture;
+        }
+
+        const std::string& GetPath() const
+        {
+            return m_path;
+        }
+
+    private:
+        friend class TextureLoader;
+
+        std::string m_path;
+        bool m_createMipMaps = true;
+        std::atomic<AsyncTextureState> m_state { AsyncTextureState::Queued };
+        Texture m_texture;
+    };
+
+    using TextureHandle = std::shared_ptr<AsyncTexture>;
+
+    struct TextureLoaderStats
+    {
+        unsigned long long requested = 0;
+        unsigned long long uploaded = 0;
+        unsigned long long failed = 0;
+        // Decoded after every handle to them was released, never uploaded
+        unsigned long long dropped = 0;
+        unsigned long long uploadedBytes = 0;
+        // Uploads that went through the staging buffer rather than client memory
+        unsigned long long stagedUploads = 0;
+        // Updates that left decoded images for later to stay within the budget
+        unsigned long long deferredUpdates = 0;
+    };
+
+    // Loads textures without stalling the frame. Files are decoded, or for DDS/KTX2
+    // containers just read and for cooked .ntex files mapped, on a pool of worker
+    // threads, which hand the pixels to the GL thread through a lock-free queue; each
+    // Update then uploads finished images until the per frame byte budget is spent,
+    // leaving the rest for the next frames.
+    //
+    // With a staging buffer the pixels are copied into a TextureUploader, sized to the
+    // budget, and reach the texture asynchronously from there; images larger than the
+    // budget and loaders initialized without one upload straight from client memory.
+    //
+    //  loader.Init();
+    //  nether::TextureHandle wall = loader.Load("media/wall.jpg");
+    //  ... every frame ...
+    //  loader.Update();
+    //  if (wall->IsReady()) wall->GetTexture().Bind(TextureUnit::Texture0);
+    //
+    // Init, Load, Update and Shutdown must be called from the GL thread.
+    class TextureLoader
+    {
+    public:
+        static constexpr long long kDefaultUploadBudget = 16 * 1024 * 1024;
+
+        TextureLoader() = default;
+        TextureLoader(const TextureLoader&) = delete;
+        TextureLoader& operator=(const TextureLoader&) = delete;
+
+        ~TextureLoader()
+        {
+            Shutdown();
+        }
+
+        // workerCount 0 uses one thread per core but the calling one. The staging buffer
+        // needs GL 4.4 (or ARB_buffer_storage).
+        void Init(int workerCount = 0, long long uploadBudgetBytes = kDefaultUploadBudget, bool useStagingBuffer = true);
+
+        // Stops the workers; textures not uploaded yet end up Failed
+        void Shutdown();
+
+        TextureHandle Load(const std::string& filePath, bool createMipMaps = true);
+
+        // Uploads decoded images, always at least one so images larger than the budget
+        // still get through. Call once per frame.
+        void Update();
+
+        // Does not resize the staging buffer, uploads over its size skip it
+        void SetUploadBudget(long long bytes)
+        {
+            m_uploadBudget = bytes;
+        }
+
+        // Requests neither uploaded nor failed yet
+        int GetPendingCount() const
+        {
+            return m_pending;
+        }
+
+        int GetWorkerCount() const
+        {
+            return int(m_workers.size());
+        }
+
+        const TextureLoaderStats& GetStats() const
+        {
+            return m_stats;
+        }
+
+        const TextureUploader& GetUploader() const
+        {
+            return m_uploader;
+        }
+
+    private:
+        struct PixelsDeleter
+        {
+            void operator()(unsigned char* pixels) const
+            {
+                Texture::FreeDecoded(pixels);
+            }
+        };
+
+        struct DecodedImage
+        {
+            TextureHandle handle;
+            // Set for images decoded with stb_image
+            std::unique_ptr<unsigned char, PixelsDeleter> pixels;
+            int width = 0;
+            int height = 0;
+            TextureFormat format = TextureFormat::RGBA8;
+            // Set for DDS/KTX2 and .ntex files, uploaded as stored with their own mip chain
+            TextureContainer container;
+            CookedTexture cooked;
+
+            // False when loading failed
+            bool IsValid() const
+            {
+                return pixels != nullptr || container.IsValid() || cooked.IsOpen();
+            }
+
+            // The stored mip chain, empty for decoded images
+            std::vector<TextureDesc> GetStoredLevels() const;
+
+            // Bytes uploaded from memory, not counting generated mipmaps
+            long long GetByteSize() const;
+        };
+
+        void WorkerMain();
+        // False when the image has to wait for the next frame's staging space
+        bool Resolve(DecodedImage& image);
+        bool Upload(AsyncTexture& texture, const DecodedImage& image);
+
+        std::vector<std::thread> m_workers;
+        std::mutex m_jobsMutex;
+        std::condition_variable m_jobsCondition;
+        std::deque<TextureHandle> m_jobs;
+        bool m_stopping = false;
+
+        MpscQueue<DecodedImage> m_decoded;
+        // Popped from m_decoded but over this frame's budget
+        std::deque<DecodedImage> m_waiting;
+
+        TextureUploader m_uploader;
+        long long m_uploadBudget = kDefaultUploadBudget;
+        int m_pending = 0;
+        TextureLoaderStats m_stats;
+    };
+
+}
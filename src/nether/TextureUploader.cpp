@@ -0,0 +1,65 @@
+#include "TextureUploader.h"
+
+#include <string.h>
+
+namespace nether {
+
+	void TextureUploader::Init(long long stagingBytesPerFrame)
+	{
+		m_staging.Generate(BufferBindingTarget::PixelUnpackBuffer, stagingBytesPerFrame);
+		// Unbound right away, a bound unpack buffer turns every texImage2D pointer
+		// into an offset
+		nether::gl::bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	}
+
+	void TextureUploader::Shutdown()
+	{
+		m_staging.Delete();
+		nether::gl::bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	}
+
+	void TextureUploader::BeginFrame()
+	{
+		m_staging.BeginFrame();
+	}
+
+	void TextureUploader::EndFrame()
+	{
+		m_staging.EndFrame();
+	}
+
+	StreamingAllocation TextureUploader::Stage(long long bytes)
+	{
+		StreamingAllocation allocation = m_staging.Allocate(bytes, 16);
+		if (!allocation.IsValid())
+		{
+			m_stats.deferred++;
+		}
+		return allocation;
+	}
+
+	bool TextureUploader::Upload(Texture& texture, int level, int width, int height, TextureFormat format, const void* pixels)
+	{
+		const long long bytes = TextureFormatUtils::GetImageSize(format, width, height);
+		StreamingAllocation staged = Stage(bytes);
+		if (!staged.IsValid())
+		{
+			return false;
+		}
+
+		memcpy(staged.data, pixels, size_t(bytes));
+		Upload(texture, level, width, height, staged);
+		return true;
+	}
+
+	void TextureUploader::Upload(Texture& texture, int level, int width, int height, const StreamingAllocation& staged)
+	{
+		m_staging.Bind();
+		texture.Upload(level, 0, 0, width, height, reinterpret_cast<const void*>(staged.offset));
+		nether::gl::bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+		m_stats.uploads++;
+		m_stats.stagedBytes += (unsigned long long)staged.size;
+	}
+
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "nether/StreamingBuffer.h"
+#include "nether/Texture.h"
+
+namespace nether
+{
+
+    struct TextureUploaderStats
+    {
+        unsigned long long uploads = 0;
+        unsigned long long stagedBytes = 0;
+        // Uploads refused because this frame's staging region was full
+        unsigned long long deferred = 0;
+    };
+
+    // Uploads texture levels through a pixel unpack buffer instead of client memory.
+    // Pixels are copied into a persistently mapped StreamingBuffer and texSubImage2D
+    // reads them from there, so the call returns as soon as the copy is queued and
+    // the transfer happens asynchronously. Staging regions are recycled through the
+    // StreamingBuffer fences, one region per frame in flight.
+    //
+    //  uploader.BeginFrame();
+    //  texture.Create(width, height, format, false);
+    //  if (!uploader.Upload(texture, 0, width, height, format, pixels)) ... retry next frame
+    //  uploader.EndFrame();
+    //
+    // Rows are tightly packed, compressed formats are whole blocks. Requires GL 4.4
+    // (or ARB_buffer_storage).
+    class TextureUploader
+    {
+    public:
+        static constexpr long long kDefaultStagingSize = 16 * 1024 * 1024;
+
+        TextureUploader() = default;
+        TextureUploader(const TextureUploader&) = delete;
+        TextureUploader& operator=(const TextureUploader&) = delete;
+
+        // stagingBytesPerFrame is the most that can be uploaded per frame
+        void Init(long long stagingBytesPerFrame = kDefaultStagingSize);
+        void Shutdown();
+
+        void BeginFrame();
+        void EndFrame();
+
+        // Reserves staging memory for callers that want to write the pixels themselves,
+        // pass it to Upload afterwards. Invalid when the region is full.
+        StreamingAllocation Stage(long long bytes);
+
+        // Copies pixels, in the texture's format, to staging and uploads them into level
+        // of texture, whose storage must already exist. Returns false, uploading nothing,
+        // when they don't fit in what is left of this frame's region.
+        bool Upload(Texture& texture, int level, int width, int height, TextureFormat format, const void* pixels);
+        void Upload(Texture& texture, int level, int width, int height, const StreamingAllocation& staged);
+
+        bool IsInitialized() const
+        {
+            return m_staging.GetBufferObject() != 0;
+        }
+
+        // Whether bytes could ever be staged, in an empty region
+        bool CanStage(long long bytes) const
+        {
+            return bytes <= m_staging.GetRegionSize();
+        }
+
+        long long GetFreeBytes() const
+        {
+            return m_staging.GetRegionSize() - m_staging.GetUsedBytes();
+        }
+
+        const TextureUploaderStats& GetStats() const
+        {
+            return m_stats;
+        }
+
+    private:
+        StreamingBuffer m_staging;
+        TextureUploaderStats m_stats;
+    };
+
+}
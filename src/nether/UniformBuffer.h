@@ -0,0 +1,163 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+#include <glm/glm.hpp>
+
+#include "nether/BufferObject.h"
+
+namespace nether
+{
+
+    // Helpers to mirror std140 uniform blocks with plain C++ structs.
+    // Scalars align to 4 bytes, vec2 to 8, vec3/vec4/mat4 columns to 16, and every
+    // array element is rounded up to 16 bytes. A vec3 followed by a scalar packs into
+    // a single vec4 slot, but a vec3 followed by another vec3 does not, which is what
+    // Padded is for.
+    namespace std140
+    {
+        template <typename T> constexpr std::size_t Alignment = alignof(T);
+        template <> constexpr std::size_t Alignment<glm::vec2> = 8;
+        template <> constexpr std::size_t Alignment<glm::ivec2> = 8;
+        template <> constexpr std::size_t Alignment<glm::vec3> = 16;
+        template <> constexpr std::size_t Alignment<glm::ivec3> = 16;
+        template <> constexpr std::size_t Alignment<glm::vec4> = 16;
+        template <> constexpr std::size_t Alignment<glm::ivec4> = 16;
+        template <> constexpr std::size_t Alignment<glm::mat4> = 16;
+
+        // Value occupying a whole 16 byte slot, e.g. array elements or consecutive vec3s
+        template <typename T>
+        struct alignas(16) Padded
+        {
+            T value;
+
+            Padded& operator=(const T& other)
+            {
+                value = other;
+                return *this;
+            }
+
+            operator const T&() const
+            {
+                return value;
+            }
+        };
+
+        template <typename T, std::size_t N>
+        using Array = Padded<T>[N];
+
+        template <typename Block>
+        constexpr bool IsValidBlock = std::is_trivially_copyable_v<Block> && sizeof(Block) % 16 == 0;
+    }
+
+#define NETHER_STD140_OFFSET(Block, member, offset) \
+    static_assert(offsetof(Block, member) == (offset), #Block "::" #member " does not match its std140 offset")
+
+    // Uniform buffer holding a single std140 block of type T, bound to a fixed binding point.
+    // Programs using the block only need ShaderProgram::BindUniformBlock once after linking.
+    template <typename T>
+    class UniformBuffer
+    {
+        static_assert(std140::IsValidBlock<T>, "uniform blocks must be trivially copyable and padded to 16 bytes");
+
+    public:
+        void Generate(unsigned int bindingPoint)
+        {
+            m_bindingPoint = bindingPoint;
+            m_buffer.Generate(BufferBindingTarget::UniformBuffer, BufferUsage::DynamicDraw);
+            m_buffer.Bind();
+            m_buffer.Allocate(sizeof(T));
+            m_buffer.BindBase(m_bindingPoint);
+            m_hasData = false;
+        }
+
+        // Uploads the block, skipped when it matches the last upload
+        void Upload(const T& data)
+        {
+            if (m_hasData && std::memcmp(&m_data, &data, sizeof(T)) == 0)
+            {
+                return;
+            }
+            m_data = data;
+            m_hasData = true;
+            m_buffer.Bind();
+            m_buffer.UploadBufferSubData(0, &m_data, sizeof(T));
+        }
+
+        // Rebinds the buffer to its binding point, only needed if something else used it
+        void Bind()
+        {
+            m_buffer.BindBase(m_bindingPoint);
+        }
+
+        void Delete()
+        {
+            m_buffer.Delete();
+        }
+
+        const T& GetData() const
+        {
+            return m_data;
+        }
+
+        unsigned int GetBindingPoint() const
+        {
+            return m_bindingPoint;
+        }
+
+        BufferObject& GetBufferObject()
+        {
+            return m_buffer;
+        }
+
+    private:
+        BufferObject m_buffer;
+        T m_data{};
+        bool m_hasData = false;
+        unsigned int m_bindingPoint = 0;
+    };
+
+    // Per frame camera data, shared by every program declaring
+    //
+    //   layout (std140) uniform Camera
+    //   {
+    //       mat4 view;
+    //       mat4 projection;
+    //       mat4 viewProjection;
+    //       vec4 position;
+    //   };
+    struct CameraBlock
+    {
+        static constexpr unsigned int Binding = 0;
+        static constexpr const char* Name = "Camera";
+
+        glm::mat4 view;
+        glm::mat4 projection;
+        glm::mat4 viewProjection;
+        glm::vec4 position;
+    };
+
+    NETHER_STD140_OFFSET(CameraBlock, view, 0);
+    NETHER_STD140_OFFSET(CameraBlock, projection, 64);
+    NETHER_STD140_OFFSET(CameraBlock, viewProjection, 128);
+    NETHER_STD140_OFFSET(CameraBlock, position, 192);
+
+    // Per draw data, usually a StreamingBuffer range bound through a DrawPacket
+    //
+    //   layout (std140) uniform Object
+    //   {
+    //       mat4 model;
+    //   };
+    struct ObjectBlock
+    {
+        static constexpr unsigned int Binding = 1;
+        static constexpr const char* Name = "Object";
+
+        glm::mat4 model;
+    };
+
+    NETHER_STD140_OFFSET(ObjectBlock, model, 0);
+
+}
@@ -1,18 +1,36 @@
 #pragma once
 
-#include "nethergl.h"
+#include "nether/NetherGL.h"
 #include <SDL.h>
 #include <glm/glm.hpp>
 #include <glm/ext.hpp>
 
 #include "nether/Color.h"
+#include "nether/CommandBuffer.h"
+#include "nether/ComputeProgram.h"
+#include "nether/CookedTexture.h"
+#include "nether/CpuProfiler.h"
+#include "nether/DrawIndirectBuffer.h"
+#include "nether/Frustum.h"
+#include "nether/FrustumCulling.h"
 #include "nether/BufferObject.h"
+#include "nether/GeometryPool.h"
+#include "nether/GpuCuller.h"
+#include "nether/GpuProfiler.h"
+#include "nether/HeadlessContext.h"
 #include "nether/Renderer.h"
 #include "nether/SDLContext.h"
 #include "nether/ShaderProgram.h"
+#include "nether/StorageBuffer.h"
+#include "nether/StreamingBuffer.h"
 #include "nether/VertexArrayObject.h"
 #include "nether/TestApp.h"
 #include "nether/Texture.h"
+#include "nether/TextureContainer.h"
+#include "nether/TextureCooker.h"
+#include "nether/TextureLoader.h"
+#include "nether/TextureUploader.h"
+#include "nether/UniformBuffer.h"
 #include "nether/Vertices.h"
 
 #include <rztl/rztl.h>
@@ -38,6 +56,9 @@ namespace nether
 
 	};
 
+	// Fly camera. View, projection and view-projection are cached and only rebuilt,
+	// on first use, after something they depend on changed, so any number of getter
+	// calls per frame (uniform upload, culling...) costs one lookAt at most.
 	class Camera
 	{
 	public:
@@ -57,24 +78,75 @@ namespace nether
 			m_pitch = pitch;
 			m_fov = fov;
 
-			m_projection = glm::perspective(glm::radians(m_fov), (float)m_screenWidth / (float)m_screenHeight, 0.1f, 100.0f);
+			m_frontDirty = true;
+			m_viewDirty = true;
+			m_projectionDirty = true;
 		}
 
 		const glm::mat4& GetProjection()
 		{
+			if (m_projectionDirty)
+			{
+				m_projection = glm::perspective(glm::radians(m_fov), (float)m_screenWidth / (float)m_screenHeight, 0.1f, 100.0f);
+				m_projectionDirty = false;
+				m_viewProjectionDirty = true;
+			}
 			return m_projection;
 		}
 
 		const glm::mat4& GetView()
 		{
-			return glm::lookAt(m_camPos, m_camPos + m_camFront, m_camUp);
+			if (m_viewDirty)
+			{
+				const glm::vec3& front = GetCamFront();
+				m_view = glm::lookAt(m_camPos, m_camPos + front, m_camUp);
+				m_viewDirty = false;
+				m_viewProjectionDirty = true;
+			}
+			return m_view;
+		}
+
+		// projection * view, what the Camera uniform block and culling need
+		const glm::mat4& GetViewProjection()
+		{
+			// Refreshing either matrix flags the product
+			GetProjection();
+			GetView();
+			if (m_viewProjectionDirty)
+			{
+				m_viewProjection = m_projection * m_view;
+				m_viewProjectionDirty = false;
+				m_frustumDirty = true;
+			}
+			return m_viewProjection;
+		}
+
+		const Frustum& GetFrustum()
+		{
+			GetViewProjection();
+			if (m_frustumDirty)
+			{
+				m_frustum = Frustum::FromMatrix(m_viewProjection);
+				m_frustumDirty = false;
+			}
+			return m_frustum;
+		}
+
+		void SetScreenSize(float sw, float sh)
+		{
+			m_screenWidth = sw;
+			m_screenHeight = sh;
+			m_projectionDirty = true;
 		}
 
 		void Move(const glm::vec3& d)
 		{
 			m_camPos += d;
+			m_viewDirty = true;
 		}
 
+		// Adds to yaw and pitch; the front vector is only rebuilt when next needed, so
+		// many mouse events per frame cost one set of trig calls
 		void Rotate(float yaw, float pitch)
 		{
 			m_yaw += yaw;
@@ -85,15 +157,21 @@ namespace nether
 			if (m_pitch < -89.0f)
 				m_pitch = -89.0f;
 
-			glm::vec3 front;
-			front.x = cos(glm::radians(yaw)) * cos(glm::radians(pitch));
-			front.y = sin(glm::radians(pitch));
-			front.z = sin(glm::radians(yaw)) * cos(glm::radians(pitch));
-			m_camFront = glm::normalize(front);
+			m_frontDirty = true;
+			m_viewDirty = true;
 		}
 
 		const glm::vec3& GetCamFront()
 		{
+			if (m_frontDirty)
+			{
+				glm::vec3 front;
+				front.x = cos(glm::radians(m_yaw)) * cos(glm::radians(m_pitch));
+				front.y = sin(glm::radians(m_pitch));
+				front.z = sin(glm::radians(m_yaw)) * cos(glm::radians(m_pitch));
+				m_camFront = glm::normalize(front);
+				m_frontDirty = false;
+			}
 			return m_camFront;
 		}
 
@@ -102,12 +180,26 @@ namespace nether
 			return m_camUp;
 		}
 
+		const glm::vec3& GetPosition()
+		{
+			return m_camPos;
+		}
+
 	private:
 		glm::vec3 m_camPos;
 		glm::vec3 m_camFront = glm::vec3(0.0f, 0.0f, -1.0f);
 		glm::vec3 m_camUp = glm::vec3(0.0f, 1.0f, 0.0f);
 
 		glm::mat4 m_projection;
+		glm::mat4 m_view;
+		glm::mat4 m_viewProjection;
+		Frustum m_frustum;
+
+		bool m_frontDirty = true;
+		bool m_viewDirty = true;
+		bool m_projectionDirty = true;
+		bool m_viewProjectionDirty = true;
+		bool m_frustumDirty = true;
 
 		float m_screenWidth;
 		float m_screenHeight;
@@ -119,5 +211,38 @@ namespace nether
 		float m_fov;
 	};
 
-}
+	// Uploads the camera matrices once per frame into the shared Camera uniform block
+	class CameraUniforms
+	{
+	public:
+		void Generate()
+		{
+			m_buffer.Generate(CameraBlock::Binding);
+		}
+
+		void Update(Camera& camera)
+		{
+			CameraBlock block;
+			block.view = camera.GetView();
+			block.projection = camera.GetProjection();
+			block.viewProjection = camera.GetViewProjection();
+			block.position = glm::vec4(camera.GetPosition(), 1.f);
+			m_buffer.Upload(block);
+		}
+
+		void Delete()
+		{
+			m_buffer.Delete();
+		}
 
+		// Points the program's Camera block at the shared binding point
+		static bool Attach(ShaderProgram& program)
+		{
+			return program.BindUniformBlock(CameraBlock::Name, CameraBlock::Binding);
+		}
+
+	private:
+		UniformBuffer<CameraBlock> m_buffer;
+	};
+
+}
@@ -30,8 +30,8 @@ public:
         cam = std::make_shared<nether::Camera>(SCR_W, SCR_H, glm::vec3{ 0, 0, 3 }, -90.f, 0.f, 45.f);
         // stbi_set_flip_vertically_on_load(true); // tell stb_image.h to flip loaded texture's on the y-axis.
 
-        tex1.LoadFromFile("media/container.jpg", nether::TextureFormat::RGB8);
-        tex2.LoadFromFile("media/awesomeface.png", nether::TextureFormat::RGBA8);
+        tex1.LoadFromFile("media/container.jpg");
+        tex2.LoadFromFile("media/awesomeface.png");
 
         vao.Generate();
         vbo.Generate(nether::BufferBindingTarget::ArrayBuffer);
@@ -88,18 +88,24 @@ public:
         vao.AddVertexAttribPointer(0, 3, nether::GLType::Float, nether::GLBoolean::False, 5 * sizeof(float), (void*)0);
         vao.EnableVertexAttribArray(0);
 
-        vao.AddVertexAttribPointer(1, 3, nether::GLType::Float, nether::GLBoolean::False, 5 * sizeof(float), (void*)(3 * sizeof(float)));
+        vao.AddVertexAttribPointer(1, 2, nether::GLType::Float, nether::GLBoolean::False, 5 * sizeof(float), (void*)(3 * sizeof(float)));
         vao.EnableVertexAttribArray(1);
 
         vbo.Unbind();
         vao.Unbind();
 
-        program.Load("media/transformations.vs", "media/transformations.fs");
+        program.Load("media/camera.vs", "media/camera.fs");
         program.Use();
 
         program.SetIntUniform("texture1", 0);
         program.SetIntUniform("texture2", 1);
 
+        // view/projection come from the shared Camera uniform block
+        cameraUniforms.Generate();
+        nether::CameraUniforms::Attach(program);
+
+        // cubes are drawn instanced, the renderer streams their model matrices
+        GetRenderer().InitInstancing();
     }
 
     virtual void Step(float delta) override
@@ -108,19 +114,10 @@ public:
         GetRenderer().BeginRender();
 
         time += delta;
-        tex1.Bind(nether::TextureUnit::Texture0);
-        tex2.Bind(nether::TextureUnit::Texture1);
-
-        glm::mat4 view = glm::mat4(1.f);
-        glm::mat4 projection = glm::mat4(1.f);
 
-        projection = cam->GetProjection();
-        view = cam->GetView();
+        cameraUniforms.Update(*cam);
 
-        program.SetMat4Uniform("projection", projection);
-        program.SetMat4Uniform("view", view);
-
-        vao.Bind();
+        commands.Clear();
 
         // world space positions of our cubes
         const std::vector<glm::vec3> cubePositions = {
@@ -142,11 +139,15 @@ public:
             model = glm::translate(model, cubePositions[i]);
             float angle = 20.f * i;
             model = glm::rotate(model, glm::radians(angle), glm::vec3(1.f, 0.3f, 0.5f));
-            program.SetMat4Uniform("model", model);
 
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            commands.DrawArrays(program.GetProgram(), vao.GetVAO(), GL_TRIANGLES, 0, 36)
+                .SetTexture(0, tex1.GetTextureID())
+                .SetTexture(1, tex2.GetTextureID())
+                .SetTransform(model);
         }
 
+        GetRenderer().Submit(commands);
+
         ProcessInput();
     }
 
@@ -155,6 +156,8 @@ public:
         vao.Delete();
         vbo.Delete();
         program.Delete();
+        cameraUniforms.Delete();
+        GetRenderer().ShutdownInstancing();
     }
 
     void ProcessInput() 
@@ -219,6 +222,8 @@ private:
     nether::Texture tex2;
 
     nether::ShaderProgram program;
+    nether::CameraUniforms cameraUniforms;
+    nether::CommandBuffer commands;
 
     std::shared_ptr<nether::Camera> cam;
 
@@ -58,8 +58,8 @@ public:
         vao.AddVertexAttribPointer(0, 3, nether::GLType::Float, nether::GLBoolean::False, 3 * sizeof(float), (void*)0);
         vao.EnableVertexAttribArray(0);
 
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glBindVertexArray(0);
+        vbo.Unbind();
+        vao.Unbind();
     }
 
     void Cleanup()
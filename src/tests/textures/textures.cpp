@@ -7,6 +7,7 @@
 #include <fstream>
 #include <sstream>
 
+#include <stb_image.h>
 
 #include <nether/nether.h>
 
@@ -17,8 +18,8 @@ public:
     {
         stbi_set_flip_vertically_on_load(true);
 
-        tex1.LoadFromFile("media/container.jpg", nether::TextureFormat::RGB8);
-        tex2.LoadFromFile("media/awesomeface.png", nether::TextureFormat::RGBA8);
+        tex1.LoadFromFile("media/container.jpg");
+        tex2.LoadFromFile("media/awesomeface.png");
         
         vao.Generate();
         vbo.Generate(nether::BufferBindingTarget::ArrayBuffer);
@@ -24,8 +24,8 @@ public:
 
         // stbi_set_flip_vertically_on_load(true); // tell stb_image.h to flip loaded texture's on the y-axis.
 
-        tex1.LoadFromFile("media/container.jpg", nether::TextureFormat::RGB8);
-        tex2.LoadFromFile("media/awesomeface.png", nether::TextureFormat::RGBA8);
+        tex1.LoadFromFile("media/container.jpg");
+        tex2.LoadFromFile("media/awesomeface.png");
         
         vao.Generate();
         vbo.Generate(nether::BufferBindingTarget::ArrayBuffer);
@@ -82,7 +82,7 @@ public:
         vao.AddVertexAttribPointer(0, 3, nether::GLType::Float, nether::GLBoolean::False, 5 * sizeof(float), (void*)0 );
         vao.EnableVertexAttribArray(0);
 
-        vao.AddVertexAttribPointer(1, 3, nether::GLType::Float, nether::GLBoolean::False, 5 * sizeof(float), (void*)(3 * sizeof(float)));
+        vao.AddVertexAttribPointer(1, 2, nether::GLType::Float, nether::GLBoolean::False, 5 * sizeof(float), (void*)(3 * sizeof(float)));
         vao.EnableVertexAttribArray(1);
 
         vbo.Unbind();
@@ -0,0 +1,120 @@
+// Cooks an image file into a .ntex file loaded with no decoding at run time, see
+// nether::TextureCooker and nether::CookedTexture.
+//
+//  nether-texcook [--format rgba8|bc1|bc3|bc5|bc] [--no-mips] [--straight-alpha] input output.ntex
+//
+// The default is RGBA8 with premultiplied alpha and a full mip chain; "bc" picks
+// BC1 for opaque images and BC3 for the others.
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <chrono>
+#include <string>
+
+#include <nether/CookedTexture.h>
+#include <nether/TextureCooker.h>
+
+namespace
+{
+    void PrintUsage()
+    {
+        printf("usage: nether-texcook [--format rgba8|bc1|bc3|bc5|bc] [--no-mips] [--straight-alpha] input output.ntex\n");
+    }
+
+    bool ParseFormat(const char* name, nether::TextureCookOptions& options)
+    {
+        options.autoCompress = strcmp(name, "bc") == 0;
+        if (strcmp(name, "rgba8") == 0 || options.autoCompress)
+        {
+            options.format = nether::TextureFormat::RGBA8;
+        }
+        else if (strcmp(name, "bc1") == 0)
+        {
+            options.format = nether::TextureFormat::BC1;
+        }
+        else if (strcmp(name, "bc3") == 0)
+        {
+            options.format = nether::TextureFormat::BC3;
+        }
+        else if (strcmp(name, "bc5") == 0)
+        {
+            options.format = nether::TextureFormat::BC5;
+        }
+        else
+        {
+            return false;
+        }
+        return true;
+    }
+
+    const char* GetFormatName(nether::TextureFormat format)
+    {
+        switch (format)
+        {
+        case nether::TextureFormat::BC1: return "BC1";
+        case nether::TextureFormat::BC3: return "BC3";
+        case nether::TextureFormat::BC5: return "BC5";
+        default: return "RGBA8";
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    nether::TextureCookOptions options;
+    const char* paths[2] = {};
+    int pathCount = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--format") == 0 && i + 1 < argc)
+        {
+            if (!ParseFormat(argv[++i], options))
+            {
+                printf("unknown format %s\n", argv[i]);
+                PrintUsage();
+                return EXIT_FAILURE;
+            }
+        }
+        else if (strcmp(argv[i], "--no-mips") == 0)
+        {
+            options.mipmaps = false;
+        }
+        else if (strcmp(argv[i], "--straight-alpha") == 0)
+        {
+            options.premultiplyAlpha = false;
+        }
+        else if (argv[i][0] != '-' && pathCount < 2)
+        {
+            paths[pathCount++] = argv[i];
+        }
+        else
+        {
+            PrintUsage();
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (pathCount != 2)
+    {
+        PrintUsage();
+        return EXIT_FAILURE;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    if (!nether::TextureCooker::Cook(paths[0], paths[1], options))
+    {
+        return EXIT_FAILURE;
+    }
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    nether::CookedTexture cooked;
+    if (!cooked.Open(paths[1]))
+    {
+        return EXIT_FAILURE;
+    }
+    printf("%s -> %s: %dx%d %s, %d levels%s, %.1f ms\n", paths[0], paths[1], cooked.GetWidth(), cooked.GetHeight(),
+        GetFormatName(cooked.GetFormat()), cooked.GetLevelCount(), cooked.IsPremultiplied() ? ", premultiplied" : "", ms);
+    return EXIT_SUCCESS;
+}